@@ -0,0 +1,40 @@
+#include <Base64.h>
+#include "../tests/Baseline.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+namespace GW2Radial
+{
+
+static std::string MakeBase64(size_t length)
+{
+	std::string encoded;
+	for (size_t i = 0; i < length; i++)
+		encoded += Baseline::base64_chars[(i * 7 + i / 3) & 0x3F];
+	return encoded;
+}
+
+static void BM_Base64Decode(benchmark::State& state)
+{
+	const auto narrow = MakeBase64(size_t(state.range(0)));
+	const std::wstring encoded(narrow.begin(), narrow.end());
+	std::vector<uint8_t> out(Base64DecodedSize(encoded.size()));
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(Base64Decode(encoded, out.data(), out.size()));
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(int64_t(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_Base64Decode)->Arg(56)->Arg(4096);
+
+static void BM_Base64DecodeBaseline(benchmark::State& state)
+{
+	const auto encoded = MakeBase64(size_t(state.range(0)));
+	for (auto _ : state)
+		benchmark::DoNotOptimize(Baseline::base64_decode(encoded));
+	state.SetBytesProcessed(int64_t(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_Base64DecodeBaseline)->Arg(56)->Arg(4096);
+
+}
@@ -0,0 +1,44 @@
+#include <ChatDedup.h>
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace GW2Radial
+{
+
+// One second of a 10k msg/s flood, a third of it repeating one of the last 50 lines, stamped 0.1 ms apart
+// in whole milliseconds. Checks every line against the default window of 64 lines and 30 seconds.
+static void BM_ChatDedupFlood(benchmark::State& state)
+{
+	constexpr int MessagesPerSecond = 10000;
+
+	std::mt19937 rng(7);
+	std::vector<std::wstring> lines;
+	for (int i = 0; i < MessagesPerSecond; i++)
+	{
+		if (i >= 50 && rng() % 3 == 0)
+			lines.push_back(lines[i - 1 - rng() % 50]);
+		else
+			lines.push_back(L"[12:34] Guild Member: on my way to the world boss, anyone need a port? " + std::to_wstring(i));
+	}
+
+	uint64_t suppressed = 0;
+	mstime start = 0;
+	for (auto _ : state)
+	{
+		ChatDedup dedup({ 64, 30000 });
+		for (int i = 0; i < MessagesPerSecond; i++)
+			benchmark::DoNotOptimize(dedup.Admit(lines[i], start + mstime(i / 10)));
+		suppressed += dedup.suppressed();
+		start += 1000;
+	}
+
+	state.SetItemsProcessed(state.iterations() * MessagesPerSecond);
+	state.counters["suppressed"] = benchmark::Counter(double(suppressed), benchmark::Counter::kAvgIterations);
+	// Share of the second spent deduplicating
+	state.counters["load"] = benchmark::Counter(double(state.iterations()), benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+BENCHMARK(BM_ChatDedupFlood);
+
+}
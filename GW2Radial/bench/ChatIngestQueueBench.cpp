@@ -0,0 +1,114 @@
+#include <ChatIngestQueue.h>
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+namespace GW2Radial
+{
+
+// Time the chat thread spends inside Push while a 10k msg/s burst arrives and the render thread
+// drains once per 16 ms frame, spending 2 ms building the chat window each time
+using BenchClock = std::chrono::steady_clock;
+static constexpr auto MessageInterval = std::chrono::microseconds(100);
+static constexpr auto FrameInterval = std::chrono::milliseconds(16);
+static constexpr auto WindowBuildTime = std::chrono::milliseconds(2);
+static constexpr int BurstMessages = 2500;
+static const wchar_t BurstLine[] = L"[12:34] Guild Member: on my way to the world boss, anyone need a port?";
+
+static void Spin(BenchClock::duration d)
+{
+	const auto until = BenchClock::now() + d;
+	while (BenchClock::now() < until)
+		;
+}
+
+template<typename Push, typename Frame>
+static void RunBurst(benchmark::State& state, Push&& push, Frame&& frame)
+{
+	double totalStall = 0, maxStall = 0;
+	int64_t messages = 0;
+	for (auto _ : state)
+	{
+		std::atomic<bool> done { false };
+		std::thread renderer([&]()
+		{
+			while (!done.load(std::memory_order_relaxed))
+			{
+				frame();
+				std::this_thread::sleep_for(FrameInterval - WindowBuildTime);
+			}
+		});
+
+		double stall = 0;
+		auto next = BenchClock::now();
+		for (int i = 0; i < BurstMessages; i++)
+		{
+			while (BenchClock::now() < next)
+				;
+			next += MessageInterval;
+
+			const auto start = BenchClock::now();
+			push(BurstLine);
+			const double elapsed = std::chrono::duration<double>(BenchClock::now() - start).count();
+			stall += elapsed;
+			maxStall = std::max(maxStall, elapsed);
+		}
+
+		done = true;
+		renderer.join();
+		state.SetIterationTime(stall);
+		totalStall += stall;
+		messages += BurstMessages;
+	}
+
+	state.counters["mean_stall_ns"] = totalStall / double(messages) * 1e9;
+	state.counters["max_stall_us"] = maxStall * 1e6;
+}
+
+static void BM_ChatIngestQueueBurst(benchmark::State& state)
+{
+	auto queue = std::make_unique<ChatIngestQueue<1024, 512>>();
+	size_t drained = 0;
+	RunBurst(state, [&](const wchar_t* text) { queue->Push(text, 0); },
+		[&]()
+		{
+			queue->Drain([&](const auto& slot) { drained += slot.length; });
+			Spin(WindowBuildTime);
+		});
+	state.counters["dropped"] = double(queue->droppedFull());
+}
+BENCHMARK(BM_ChatIngestQueueBurst)->UseManualTime()->Iterations(2)->Unit(benchmark::kMicrosecond);
+
+// The queue it replaced: a locked std::queue of _wcsdup'd strings, with the lock held while the window is built
+static void BM_LockedQueueBurst(benchmark::State& state)
+{
+	std::mutex lock;
+	std::queue<wchar_t*> lines;
+	RunBurst(state,
+		[&](const wchar_t* text)
+		{
+			const auto length = wcslen(text) + 1;
+			auto* copy = static_cast<wchar_t*>(malloc(length * sizeof(wchar_t)));
+			wmemcpy(copy, text, length);
+			std::lock_guard<std::mutex> guard(lock);
+			lines.push(copy);
+		},
+		[&]()
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			while (!lines.empty())
+			{
+				free(lines.front());
+				lines.pop();
+			}
+			Spin(WindowBuildTime);
+		});
+}
+BENCHMARK(BM_LockedQueueBurst)->UseManualTime()->Iterations(2)->Unit(benchmark::kMicrosecond);
+
+}
@@ -0,0 +1,37 @@
+#include <ChatLink.h>
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+namespace GW2Radial
+{
+
+// A million links, cycling through a player, an item with upgrades, a skill and a map, decoded and described
+static void BM_DecodeChatLinks(benchmark::State& state)
+{
+	const std::vector<std::wstring> links
+	{
+		L"CGFMngACJRHqgbaVEDwNZJJNAGkAeQB1AGsAaQBuAHkAYQAAAA==",
+		L"AgGqtgDgfQ4AAP9fAAAnYAAA",
+		L"BucCAAA=",
+		L"BDgAAAA=",
+	};
+	constexpr size_t count = 1000000;
+
+	ChatLinkBuffer buffer;
+	std::string description;
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			const auto link = DecodeChatLink(links[i & 3], buffer);
+			description.clear();
+			link.Describe(description);
+			benchmark::DoNotOptimize(description.data());
+		}
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(count));
+}
+BENCHMARK(BM_DecodeChatLinks)->Unit(benchmark::kMillisecond);
+
+}
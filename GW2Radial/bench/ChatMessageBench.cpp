@@ -0,0 +1,108 @@
+#include <ChatMessage.h>
+#include <ChatLog.h>
+#include "../tests/Baseline.h"
+#include <benchmark/benchmark.h>
+#include <queue>
+
+namespace GW2Radial
+{
+
+// A chat line of roughly state.range(0) characters
+static std::wstring MakeChatLine(size_t length)
+{
+	std::wstring line = L"<quote>[&CGFMngACJRHqgbaVEDwNZJJNAGkAeQB1AGsAaQBuAHkAYQAAAA==]: ";
+	while (line.size() < length)
+		line += L"on my way to the world boss ";
+	return line;
+}
+
+static void BM_ScanChatQuote(benchmark::State& state)
+{
+	const auto line = MakeChatLine(size_t(state.range(0)));
+	std::wstring_view link, body;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(ScanChatQuote(line, link, body));
+		benchmark::DoNotOptimize(body.data());
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ScanChatQuote)->RangeMultiplier(4)->Range(64, 1024);
+
+static void BM_ChatQuoteRegex(benchmark::State& state)
+{
+	const auto line = MakeChatLine(size_t(state.range(0)));
+	std::wstring link, body;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(Baseline::ChatQuoteRegex(line, link, body));
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ChatQuoteRegex)->RangeMultiplier(4)->Range(64, 1024);
+
+// Distinct lines, so the old adjacent duplicate check skips none of them
+static std::vector<std::wstring> MakeChatLines(size_t count)
+{
+	std::vector<std::wstring> lines;
+	for (size_t i = 0; i < count; i++)
+		lines.push_back(MakeChatLine(96) + std::to_wstring(i));
+	return lines;
+}
+
+// What DrawTextDatas did on every frame before lines were parsed at ingest: copy the queue,
+// then run FilterShit and the UTF-8 conversion on each line. The ImGui::Text call is left out of both sides.
+static void BM_FrameReparse(benchmark::State& state)
+{
+	std::queue<std::wstring> queue;
+	for (auto& line : MakeChatLines(size_t(state.range(0))))
+		queue.push(std::move(line));
+
+	for (auto _ : state)
+	{
+		auto tmp = queue;
+		std::wstring last;
+		size_t bytes = 0;
+		while (!tmp.empty())
+		{
+			const auto& txt = tmp.front();
+			if (last != txt)
+			{
+				const auto filtered = Baseline::FilterShit(txt);
+				if (filtered != L"NONE")
+				{
+					bytes += utf8_encode(filtered).size();
+					last = txt;
+				}
+			}
+			tmp.pop();
+		}
+		benchmark::DoNotOptimize(bytes);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FrameReparse)->Arg(10)->Arg(100)->Arg(1000);
+
+// The same frame now: the retained messages are already parsed, so it only walks them
+static void BM_FrameRetained(benchmark::State& state)
+{
+	const auto count = size_t(state.range(0));
+	ChatLog log({ count, 0, ~size_t(0) });
+	for (const auto& line : MakeChatLines(count))
+		log.Append(line, 0);
+	if (log.size() != count)
+		state.SkipWithError("chat lines were not retained");
+
+	for (auto _ : state)
+	{
+		size_t bytes = 0;
+		for (size_t i = 0; i < log.size(); i++)
+		{
+			benchmark::DoNotOptimize(log[i].text().data());
+			bytes += log[i].text().size();
+		}
+		benchmark::DoNotOptimize(bytes);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FrameRetained)->Arg(10)->Arg(100)->Arg(1000);
+
+}
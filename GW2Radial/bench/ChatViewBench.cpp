@@ -0,0 +1,50 @@
+#include <ChatView.h>
+#include "../tests/HeadlessImGui.h"
+#include <benchmark/benchmark.h>
+
+namespace GW2Radial
+{
+
+// One frame of a 600x400 chat window holding 5000 lines, scrolled to the middle, without a device.
+// CPU time is building the frame; the counters are what it hands the renderer.
+template<typename Content>
+static void RunChatFrames(benchmark::State& state, Content&& content)
+{
+	HeadlessImGui gui;
+	ChatLog log({ 5000, 0, ~size_t(0) });
+	FillChatLog(log, 5000);
+
+	// The line height is only known once a frame has set up the font
+	gui.Frame(0.f, [&] { content(log); });
+	const float scrollY = log.size() * ImGui::GetTextLineHeightWithSpacing() / 2;
+	gui.Frame(scrollY, [&] { content(log); });
+	gui.Frame(scrollY, [&] { content(log); });
+
+	int64_t vertices = 0;
+	for (auto _ : state)
+		vertices += gui.Frame(scrollY, [&] { content(log); }).TotalVtxCount;
+
+	state.counters["vertices"] = benchmark::Counter(double(vertices), benchmark::Counter::kAvgIterations);
+}
+
+static void BM_ChatWindowAllLines(benchmark::State& state)
+{
+	RunChatFrames(state, DrawAllChatLines);
+}
+BENCHMARK(BM_ChatWindowAllLines);
+
+static void BM_ChatWindowClipped(benchmark::State& state)
+{
+	RunChatFrames(state, DrawClippedChatLines);
+}
+BENCHMARK(BM_ChatWindowClipped);
+
+static void BM_ChatView(benchmark::State& state)
+{
+	ChatView view;
+	RunChatFrames(state, [&](const ChatLog& log) { view.Draw(log); });
+	state.counters["cacheMisses"] = double(view.cacheMisses());
+}
+BENCHMARK(BM_ChatView);
+
+}
@@ -0,0 +1,72 @@
+#include <InputDispatcher.h>
+#include <Main.h>
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+namespace GW2Radial
+{
+
+struct BenchMessage
+{
+	uint msg;
+	uintptr_t wParam;
+	intptr_t lParam;
+};
+
+// Mostly mouse moves with key and button presses mixed in, as the game window sees during play
+static std::vector<BenchMessage> MakeMessages(size_t count)
+{
+	static const uint keys[] = { VK_SHIFT, VK_CONTROL, 'W', 'A', 'S', 'D', 'Q', 'E', '1', '2' };
+	std::mt19937 rng(12);
+	std::uniform_int_distribution<size_t> kind(0, 9), key(0, std::size(keys) - 1);
+	std::array<bool, 256> down { };
+	std::vector<BenchMessage> messages;
+	messages.reserve(count);
+	while (messages.size() < count)
+	{
+		const auto k = kind(rng);
+		if (k < 6)
+			messages.push_back({ WM_MOUSEMOVE, 0, 0 });
+		else if (k < 9)
+		{
+			const uint vk = keys[key(rng)];
+			messages.push_back({ (down[vk] = !down[vk]) ? WM_KEYDOWN : WM_KEYUP, vk, intptr_t(vk == VK_SHIFT ? 0x2A : 0x10) << 16 });
+		}
+		else
+		{
+			messages.push_back({ (down[0] = !down[0]) ? WM_RBUTTONDOWN : WM_RBUTTONUP, 0, 0 });
+		}
+	}
+	return messages;
+}
+
+static void BM_DispatchMessages(benchmark::State& state)
+{
+	const auto messages = MakeMessages(100000);
+
+	InputDispatcher dispatcher;
+	// One callback per wheel, each checking its keybind against the held keys
+	std::vector<InputDispatcher::InputChangeCallback> wheels;
+	for (uint i = 0; i < uint(state.range(0)); i++)
+		wheels.emplace_back([combo = KeyCombo { VK_LSHIFT, uint('1' + i % 9) }](bool changed, const KeyCombo& keys, const EventKeys&)
+		{
+			return changed && keys.includes(combo) ? InputResponse::PREVENT_ALL : InputResponse::PASS_TO_GAME;
+		});
+	for (auto& cb : wheels)
+		dispatcher.AddInputChangeCallback(&cb);
+	InputDispatcher::MouseMoveCallback moves = [] { return false; };
+	dispatcher.AddMouseMoveCallback(&moves);
+
+	for (auto _ : state)
+	{
+		uint blocked = 0;
+		for (const auto& m : messages)
+			blocked += uint(dispatcher.Dispatch(InputDispatcher::Translate(m.msg, m.wParam, m.lParam, true), m.msg == WM_MOUSEMOVE));
+		benchmark::DoNotOptimize(blocked);
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(messages.size()));
+}
+BENCHMARK(BM_DispatchMessages)->Arg(1)->Arg(8);
+
+}
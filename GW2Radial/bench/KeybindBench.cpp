@@ -0,0 +1,270 @@
+#include <ConfigurationFile.h>
+#include <Keybind.h>
+#include "../tests/KeybindBaseline.h"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <random>
+
+namespace GW2Radial
+{
+
+// 50 or 500 keybinds of one to three keys drawn from modifiers and a handful of letters, and a stream of
+// key presses and releases over the same keys, so chords are regularly held and shadow each other.
+// At 500 there are more keybinds than distinct chords, so many of them conflict as well.
+static const uint BenchKeys[] = { VK_LCONTROL, VK_RCONTROL, VK_LSHIFT, VK_LMENU, 'Q', 'W', 'E', 'R', 'T', 'F', 'G', 'V' };
+// Fewer events for more keybinds keeps the scanning baseline's run time in check
+static constexpr size_t BenchEventsTimesKeybinds = 10000000;
+
+struct KeyEvent
+{
+	uint key;
+	bool down;
+};
+
+static std::vector<std::vector<uint>> MakeChords(size_t count, uint seed = 11)
+{
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<size_t> key(0, std::size(BenchKeys) - 1), size(1, 3);
+	std::vector<std::vector<uint>> chords;
+	while (chords.size() < count)
+	{
+		std::vector<uint> chord;
+		for (size_t n = size(rng); chord.size() < n;)
+		{
+			const auto k = BenchKeys[key(rng)];
+			if (std::find(chord.begin(), chord.end(), k) == chord.end())
+				chord.push_back(k);
+		}
+		chords.push_back(chord);
+	}
+	return chords;
+}
+
+static std::vector<KeyEvent> MakeEvents(size_t keybinds)
+{
+	std::mt19937 rng(12);
+	std::uniform_int_distribution<size_t> key(0, std::size(BenchKeys) - 1);
+	std::array<bool, 256> down { };
+	std::vector<KeyEvent> events(BenchEventsTimesKeybinds / keybinds);
+	for (auto& e : events)
+	{
+		e.key = BenchKeys[key(rng)];
+		e.down = down[e.key] = !down[e.key];
+	}
+	return events;
+}
+
+static KeyCombo ToKeyCombo(const std::vector<uint>& chord)
+{
+	KeyCombo keys;
+	for (auto k : chord)
+		keys.insert(k);
+	return keys;
+}
+
+static std::vector<std::unique_ptr<Keybind>> MakeKeybinds(size_t count)
+{
+	std::vector<std::unique_ptr<Keybind>> keybinds;
+	for (const auto& chord : MakeChords(count))
+		keybinds.push_back(std::make_unique<Keybind>("bench" + std::to_string(keybinds.size()), "Bench", ToKeyCombo(chord), false));
+	return keybinds;
+}
+
+static void BM_KeyComboEvents(benchmark::State& state)
+{
+	const auto keybinds = MakeKeybinds(size_t(state.range(0)));
+	const auto events = MakeEvents(keybinds.size());
+
+	for (auto _ : state)
+	{
+		KeyCombo pressed;
+		size_t held = 0;
+		for (const auto& e : events)
+		{
+			if (e.down)
+				pressed.insert(e.key);
+			else
+				pressed.erase(e.key);
+
+			for (const auto& kb : keybinds)
+				held += kb->matchesPartial(pressed) && !kb->conflicts(pressed);
+		}
+		benchmark::DoNotOptimize(held);
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(events.size()));
+}
+BENCHMARK(BM_KeyComboEvents)->Arg(50)->Arg(500)->Unit(benchmark::kMillisecond);
+
+static void BM_KeySetEvents(benchmark::State& state)
+{
+	Baseline::SetKeybindRegistry keybinds;
+	for (const auto& chord : MakeChords(size_t(state.range(0))))
+		keybinds.Add(Baseline::KeySet(chord.begin(), chord.end()));
+	const auto events = MakeEvents(keybinds.size());
+
+	for (auto _ : state)
+	{
+		Baseline::KeySet pressed;
+		size_t held = 0;
+		for (const auto& e : events)
+		{
+			if (e.down)
+				pressed.insert(e.key);
+			else
+				pressed.erase(e.key);
+
+			for (size_t kb = 0; kb < keybinds.size(); kb++)
+				held += keybinds.held(kb, pressed);
+		}
+		benchmark::DoNotOptimize(held);
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(events.size()));
+}
+BENCHMARK(BM_KeySetEvents)->Arg(50)->Arg(500)->Unit(benchmark::kMillisecond);
+
+// The user rebinding keybinds one after another, each change updating every conflict flag
+static void BM_KeybindRebind(benchmark::State& state)
+{
+	const auto keybinds = MakeKeybinds(size_t(state.range(0)));
+	std::vector<KeyCombo> rebinds;
+	for (const auto& chord : MakeChords(keybinds.size(), 13))
+		rebinds.push_back(ToKeyCombo(chord));
+
+	size_t next = 0, conflicted = 0;
+	for (auto _ : state)
+	{
+		auto& kb = *keybinds[next];
+		kb.isBeingModified(true);
+		kb.keys(rebinds[next]);
+		kb.isBeingModified(false);
+		conflicted += kb.isConflicted();
+		next = (next + 1) % keybinds.size();
+	}
+	benchmark::DoNotOptimize(conflicted);
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_KeybindRebind)->Arg(50)->Arg(500);
+
+static void BM_KeySetRebind(benchmark::State& state)
+{
+	Baseline::SetKeybindRegistry keybinds;
+	for (const auto& chord : MakeChords(size_t(state.range(0))))
+		keybinds.Add(Baseline::KeySet(chord.begin(), chord.end()));
+	std::vector<Baseline::KeySet> rebinds;
+	for (const auto& chord : MakeChords(keybinds.size(), 13))
+		rebinds.emplace_back(chord.begin(), chord.end());
+
+	size_t next = 0, conflicted = 0;
+	for (auto _ : state)
+	{
+		keybinds.Set(next, rebinds[next]);
+		conflicted += keybinds.conflicted()[next];
+		next = (next + 1) % keybinds.size();
+	}
+	benchmark::DoNotOptimize(conflicted);
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_KeySetRebind)->Arg(50)->Arg(500);
+
+
+// Startup: every keybind is read from the configuration as text, parsed, and written back
+static std::vector<std::string> MakeConfigValues(size_t count)
+{
+	std::vector<std::string> values;
+	for (const auto& chord : MakeChords(count))
+	{
+		KeyCombo::SerializedBuffer buffer;
+		values.emplace_back(ToKeyCombo(chord).Serialize(buffer));
+	}
+	return values;
+}
+
+static void BM_KeyComboParse(benchmark::State& state)
+{
+	const auto values = MakeConfigValues(size_t(state.range(0)));
+
+	for (auto _ : state)
+	{
+		KeyCombo keys;
+		for (const auto& v : values)
+		{
+			KeyCombo::Parse(v, keys);
+			benchmark::DoNotOptimize(keys);
+		}
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(values.size()));
+}
+BENCHMARK(BM_KeyComboParse)->Arg(100)->Arg(500);
+
+static void BM_KeySetParse(benchmark::State& state)
+{
+	const auto values = MakeConfigValues(size_t(state.range(0)));
+
+	for (auto _ : state)
+	{
+		for (const auto& v : values)
+			benchmark::DoNotOptimize(Baseline::ParseKeys(v.c_str()));
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(values.size()));
+}
+BENCHMARK(BM_KeySetParse)->Arg(100)->Arg(500);
+
+static void BM_KeyComboSerialize(benchmark::State& state)
+{
+	std::vector<KeyCombo> keys;
+	for (const auto& chord : MakeChords(size_t(state.range(0))))
+		keys.push_back(ToKeyCombo(chord));
+
+	for (auto _ : state)
+	{
+		KeyCombo::SerializedBuffer buffer;
+		for (const auto& k : keys)
+			benchmark::DoNotOptimize(k.Serialize(buffer));
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(keys.size()));
+}
+BENCHMARK(BM_KeyComboSerialize)->Arg(100)->Arg(500);
+
+static void BM_KeySetSerialize(benchmark::State& state)
+{
+	std::vector<Baseline::KeySet> keys;
+	for (const auto& chord : MakeChords(size_t(state.range(0))))
+		keys.emplace_back(chord.begin(), chord.end());
+
+	for (auto _ : state)
+	{
+		for (const auto& k : keys)
+			benchmark::DoNotOptimize(Baseline::SerializeKeys(k));
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(keys.size()));
+}
+BENCHMARK(BM_KeySetSerialize)->Arg(100)->Arg(500);
+
+// The whole load as Keybind's configuration constructor does it: parse, index, serialize and save
+static void BM_KeybindConfigLoad(benchmark::State& state)
+{
+	const auto values = MakeConfigValues(size_t(state.range(0)));
+	std::vector<std::string> nicknames;
+	for (const auto& v : values)
+	{
+		nicknames.push_back("load" + std::to_string(nicknames.size()));
+		ConfigurationFile::i()->ini().SetValue("Keybinds", nicknames.back().c_str(), v.c_str());
+	}
+
+	for (auto _ : state)
+	{
+		std::vector<std::unique_ptr<Keybind>> keybinds;
+		keybinds.reserve(nicknames.size());
+		for (const auto& n : nicknames)
+			keybinds.push_back(std::make_unique<Keybind>(n, "Bench"));
+		benchmark::DoNotOptimize(keybinds.back()->isConflicted());
+
+		state.PauseTiming();
+		keybinds.clear();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(nicknames.size()));
+}
+BENCHMARK(BM_KeybindConfigLoad)->Arg(100)->Arg(500)->Unit(benchmark::kMicrosecond);
+
+}
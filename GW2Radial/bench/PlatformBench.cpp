@@ -0,0 +1,32 @@
+#include <Platform.h>
+#include <Clock.h>
+#include <benchmark/benchmark.h>
+
+namespace GW2Radial
+{
+
+static void BM_ClockMicroseconds(benchmark::State& state)
+{
+	for (auto _ : state)
+		benchmark::DoNotOptimize(Clock::microseconds());
+}
+BENCHMARK(BM_ClockMicroseconds);
+
+static void BM_ClockFrameMicroseconds(benchmark::State& state)
+{
+	Clock::BeginFrame();
+	for (auto _ : state)
+		benchmark::DoNotOptimize(Clock::frameMicroseconds());
+}
+BENCHMARK(BM_ClockFrameMicroseconds);
+
+static void BM_Utf8Encode(benchmark::State& state)
+{
+	const std::wstring line = L"[12:34] Guild Member: Grüße aus Löwenstein, wer kommt mit zur Weltboss-Kette?";
+	for (auto _ : state)
+		benchmark::DoNotOptimize(utf8_encode(line));
+	state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(line.size() * sizeof(wchar_t)));
+}
+BENCHMARK(BM_Utf8Encode);
+
+}
@@ -0,0 +1,50 @@
+#include "../tests/RecordedRawInput.h"
+#include <benchmark/benchmark.h>
+
+namespace GW2Radial
+{
+
+// Classifies every WM_INPUT of a recorded second of 8000 Hz mouse input with keyboard and gamepad traffic.
+// The recorded source copies from memory, so this measures the classification and the copy, not the
+// system call GetRawInputData makes in the game.
+static void BM_RawInputHeaderOnly(benchmark::State& state)
+{
+	RecordedRawInput input;
+	const auto handles = input.AddGamingSecond();
+
+	for (auto _ : state)
+	{
+		size_t mice = 0;
+		for (const auto handle : handles)
+			mice += IsRawInputMouse(input, handle);
+		benchmark::DoNotOptimize(mice);
+	}
+	state.SetItemsProcessed(state.iterations() * handles.size());
+}
+BENCHMARK(BM_RawInputHeaderOnly);
+
+// What classification did before: copy the whole packet, then look at its header
+static void BM_RawInputWholePacket(benchmark::State& state)
+{
+	RecordedRawInput input;
+	const auto handles = input.AddGamingSecond();
+
+	for (auto _ : state)
+	{
+		size_t mice = 0;
+		for (const auto handle : handles)
+		{
+			uint8_t buffer[sizeof(RawInputHeader) + RecordedRawInput::HidPayload];
+			const auto& packet = input.Packet(handle);
+			memcpy(buffer, packet.data(), packet.size());
+			RawInputHeader header;
+			memcpy(&header, buffer, sizeof(header));
+			mice += header.type == RawInputHeader::Mouse;
+		}
+		benchmark::DoNotOptimize(mice);
+	}
+	state.SetItemsProcessed(state.iterations() * handles.size());
+}
+BENCHMARK(BM_RawInputWholePacket);
+
+}
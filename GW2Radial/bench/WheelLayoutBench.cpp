@@ -0,0 +1,84 @@
+#include <WheelLayout.h>
+#include "../tests/WheelLayoutBaseline.h"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <memory>
+#include <random>
+
+namespace GW2Radial
+{
+
+// 100k mouse moves over an open wheel, each one finding the hovered element as Wheel::OnMouseMove does.
+// Every third element has no keybind, so the active ones are a subset as on a partly configured wheel.
+static constexpr size_t BenchMouseMoves = 100000;
+
+struct BenchElement
+{
+	bool active;
+	bool isActive() const { return active; }
+};
+
+static std::vector<BenchElement> MakeElements(size_t count)
+{
+	std::vector<BenchElement> elements(count);
+	for (size_t i = 0; i < count; i++)
+		elements[i].active = i % 3 != 2;
+	return elements;
+}
+
+static std::vector<fVector2> MakeMouseMoves()
+{
+	std::mt19937 rng(21);
+	std::uniform_real_distribution<float> offset(-0.2f, 0.2f);
+	std::vector<fVector2> moves(BenchMouseMoves);
+	for (auto& m : moves)
+		m = { offset(rng), offset(rng) };
+	return moves;
+}
+
+// What the render thread publishes and the input thread reads
+struct BenchActiveElements
+{
+	std::vector<const BenchElement*> elements;
+	WheelLayout layout;
+};
+
+static void BM_WheelHoverSnapshot(benchmark::State& state)
+{
+	const auto elements = MakeElements(size_t(state.range(0)));
+	const auto moves = MakeMouseMoves();
+
+	auto active = std::make_shared<BenchActiveElements>();
+	for (const auto& e : elements)
+		if (e.isActive())
+			active->elements.push_back(&e);
+	active->layout = WheelLayout(active->elements.size());
+	std::shared_ptr<const BenchActiveElements> published = std::move(active);
+
+	for (auto _ : state)
+	{
+		for (const auto& m : moves)
+		{
+			const auto snapshot = std::atomic_load_explicit(&published, std::memory_order_acquire);
+			benchmark::DoNotOptimize(snapshot->elements[snapshot->layout.HoveredSector({ -m.x, -m.y })]);
+		}
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(moves.size()));
+}
+BENCHMARK(BM_WheelHoverSnapshot)->Arg(6)->Arg(16)->Unit(benchmark::kMicrosecond);
+
+static void BM_WheelHoverBaseline(benchmark::State& state)
+{
+	const auto elements = MakeElements(size_t(state.range(0)));
+	const auto moves = MakeMouseMoves();
+
+	for (auto _ : state)
+	{
+		for (const auto& m : moves)
+			benchmark::DoNotOptimize(Baseline::Hovered(elements, { -m.x, -m.y }));
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(moves.size()));
+}
+BENCHMARK(BM_WheelHoverBaseline)->Arg(6)->Arg(16)->Unit(benchmark::kMicrosecond);
+
+}
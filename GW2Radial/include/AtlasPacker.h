@@ -0,0 +1,62 @@
+#pragma once
+#include <Platform.h>
+#include <cstdint>
+#include <vector>
+
+namespace GW2Radial
+{
+
+// Places images side by side in an atlas, with stb_rect_pack on a grid of cells coarse enough that each kept mip level of
+// the atlas is the images' own levels copied block for block, rather than the atlas being filtered down anew.
+// Every image is surrounded by a border one cell wide, which CopyLevel fills with the image's edge texels. The border is
+// at least a block wide on every kept level, so bilinear filtering at an image's edge reads what clamp addressing
+// would give it, never a neighbor. Cells are kept to a few texels by dropping the smallest mip levels.
+class AtlasPacker
+{
+public:
+	// How a format lays out the texels of a block, which decides how CopyLevel repeats them into a border
+	enum class Encoding
+	{
+		Texels,
+		DXT1,
+		DXT3,
+		DXT5
+	};
+
+	struct Format
+	{
+		Encoding encoding;
+		uint blockSize; // Texels along each side of a block, 1 for uncompressed formats
+		uint bytesPerBlock;
+	};
+
+	struct Image
+	{
+		uint width, height;
+	};
+
+	struct Position
+	{
+		uint x, y;
+	};
+
+	struct Layout
+	{
+		uint width = 0, height = 0;
+		uint levels = 0;
+		uint cellSize = 0; // Also the width of the border around each image
+		std::vector<Position> positions; // Top left corner of each image, in texels of the top level
+	};
+
+	// Places images, whose dimensions must be multiples of blockSize, in an atlas no larger than maxDimension.
+	// Keeps up to maxLevels mip levels, fewer if the images cannot all be halved that often while staying block aligned,
+	// or if keeping them would need a border wider than maxBorder texels; the border is never narrower than a block.
+	static bool Pack(const std::vector<Image>& images, uint blockSize, uint maxLevels, uint maxBorder, uint maxDimension, bool powerOfTwo, Layout& layout);
+
+	// Copies one mip level of an image from src to its position in the same level of the atlas at dst, and fills the
+	// border around it with the image's edge texels repeated outwards
+	static void CopyLevel(const Layout& layout, const Image& image, const Position& position, uint level, const Format& format,
+	                      const uint8_t* src, uint srcPitch, uint8_t* dst, uint dstPitch);
+};
+
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace GW2Radial
+{
+
+// Upper bound on the number of bytes Base64Decode can produce for an input of the given length
+constexpr size_t Base64DecodedSize(size_t length)
+{
+	return length / 4 * 3 + (length % 4 > 1 ? length % 4 - 1 : 0);
+}
+
+// Decodes standard base64 into out, stopping at the first padding or non-alphabet character.
+// A trailing group of n < 4 characters yields n - 1 bytes, since chat links are not always padded.
+// Never writes more than outSize bytes; returns the number of bytes written.
+size_t Base64Decode(std::wstring_view in, uint8_t* out, size_t outSize);
+
+}
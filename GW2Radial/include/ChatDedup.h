@@ -0,0 +1,59 @@
+#pragma once
+#include <Platform.h>
+#include <xxhash/xxhash.h>
+#include <string_view>
+
+namespace GW2Radial
+{
+
+// Suppresses chat lines which repeat one seen recently, whether or not they were adjacent.
+// Remembers the hashes of the last admitted lines in a FIFO window bounded by count and age,
+// indexed by a linear-probing hash set so each check is O(1) and allocation free.
+class ChatDedup
+{
+public:
+	struct Limits
+	{
+		size_t maxLines; // Number of recent lines remembered
+		mstime window; // In milliseconds, 0 to only bound by line count
+	};
+
+	explicit ChatDedup(const Limits& limits);
+
+	const Limits& limits() const { return limits_; }
+
+	uint64_t admitted() const { return admitted_; }
+	uint64_t suppressed() const { return suppressed_; }
+
+	// Returns false if an identical line was admitted within the window
+	bool Admit(std::wstring_view raw, mstime time);
+	void Clear();
+
+protected:
+	struct Entry
+	{
+		XXH64_hash_t hash;
+		mstime time;
+	};
+
+	// Finds the table slot holding hash, or the empty slot where it would go
+	size_t Find(XXH64_hash_t hash) const;
+	void Expire(mstime time);
+	void EraseFromTable(XXH64_hash_t hash);
+
+	Limits limits_;
+
+	// Admission order, oldest at first_
+	std::vector<Entry> fifo_;
+	size_t first_ = 0;
+	size_t count_ = 0;
+
+	// Power of two sized, kept at most half full; a hash of 0 marks an empty slot
+	std::vector<XXH64_hash_t> table_;
+	size_t mask_ = 0;
+
+	uint64_t admitted_ = 0;
+	uint64_t suppressed_ = 0;
+};
+
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include <atomic>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cwchar>
+
+namespace GW2Radial
+{
+
+// What to do with a message which does not fit in a single slot
+enum class ChatOverflowPolicy : int
+{
+	TRUNCATE = 0, // Keep as much of the message as fits in the slot
+	DROP = 1 // Discard the message entirely
+};
+
+// Bounded single-producer/single-consumer queue of preallocated chat message slots.
+// The producer is the game's chat event thread and the consumer is the render thread;
+// neither side ever takes a lock, allocates or waits on the other.
+// When all slots are in use, the incoming message is dropped and counted.
+template<size_t SlotCount, size_t SlotChars>
+class ChatIngestQueue
+{
+	static_assert(SlotCount > 0 && (SlotCount & (SlotCount - 1)) == 0, "Slot count must be a power of two");
+	static_assert(SlotChars > 1, "Slots must be able to hold at least one character");
+
+public:
+	struct Slot
+	{
+		uint64_t time; // Arrival time, as given by the producer
+		size_t length;
+		wchar_t text[SlotChars];
+	};
+
+	explicit ChatIngestQueue(ChatOverflowPolicy policy = ChatOverflowPolicy::TRUNCATE) : policy_(policy) { }
+	ChatIngestQueue(const ChatIngestQueue&) = delete;
+	ChatIngestQueue& operator=(const ChatIngestQueue&) = delete;
+
+	static constexpr size_t capacity() { return SlotCount; }
+	static constexpr size_t slotChars() { return SlotChars - 1; }
+
+	ChatOverflowPolicy policy() const { return policy_; }
+
+	uint64_t droppedFull() const { return droppedFull_.load(std::memory_order_relaxed); }
+	uint64_t droppedOversized() const { return droppedOversized_.load(std::memory_order_relaxed); }
+	uint64_t truncated() const { return truncated_.load(std::memory_order_relaxed); }
+
+	// Producer side only; returns false if the message was dropped
+	bool Push(const wchar_t* text, uint64_t time)
+	{
+		const auto tail = tail_.load(std::memory_order_relaxed);
+		if (tail - cachedHead_ == SlotCount)
+		{
+			cachedHead_ = head_.load(std::memory_order_acquire);
+			if (tail - cachedHead_ == SlotCount)
+			{
+				droppedFull_.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+		}
+
+		auto length = wcsnlen(text, SlotChars);
+		if (length == SlotChars)
+		{
+			if (policy_ == ChatOverflowPolicy::DROP)
+			{
+				droppedOversized_.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+
+			truncated_.fetch_add(1, std::memory_order_relaxed);
+			length = SlotChars - 1;
+		}
+
+		auto& slot = slots_[tail & (SlotCount - 1)];
+		wmemcpy(slot.text, text, length);
+		slot.text[length] = L'\0';
+		slot.length = length;
+		slot.time = time;
+
+		tail_.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer side only; invokes cb(const Slot&) for every pending message, oldest first,
+	// and returns the number of messages consumed
+	template<typename Callback>
+	size_t Drain(Callback&& cb)
+	{
+		const auto head = head_.load(std::memory_order_relaxed);
+		const auto tail = tail_.load(std::memory_order_acquire);
+
+		for (auto i = head; i != tail; ++i)
+			cb(static_cast<const Slot&>(slots_[i & (SlotCount - 1)]));
+
+		head_.store(tail, std::memory_order_release);
+		return tail - head;
+	}
+
+	// Safe to call from either side, but only approximate while the other side is running
+	bool empty() const { return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire); }
+
+protected:
+	// Producer and consumer indices live on their own cache lines to avoid false sharing
+	alignas(64) std::atomic<size_t> head_ { 0 };
+	alignas(64) std::atomic<size_t> tail_ { 0 };
+	size_t cachedHead_ = 0;
+
+	alignas(64) std::atomic<uint64_t> droppedFull_ { 0 };
+	std::atomic<uint64_t> droppedOversized_ { 0 };
+	std::atomic<uint64_t> truncated_ { 0 };
+
+	const ChatOverflowPolicy policy_;
+
+	std::array<Slot, SlotCount> slots_;
+};
+
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include <Base64.h>
+#include <array>
+#include <string>
+
+namespace GW2Radial
+{
+
+// Leading byte of a decoded [&...] chat link
+enum class ChatLinkType : uint8_t
+{
+	INVALID = 0x00,
+	COIN = 0x01,
+	ITEM = 0x02,
+	NPC_TEXT = 0x03,
+	MAP = 0x04,
+	SKILL = 0x06,
+	TRAIT = 0x07,
+	PLAYER = 0x08,
+	RECIPE = 0x09,
+	WARDROBE = 0x0A,
+	OUTFIT = 0x0B,
+	WVW_OBJECTIVE = 0x0C
+};
+
+// Fixed part of each link type's payload, i.e. everything after the type byte
+template<ChatLinkType T>
+struct ChatLinkLayout;
+
+template<>
+struct ChatLinkLayout<ChatLinkType::COIN> { static constexpr size_t size = 4; };
+
+template<>
+struct ChatLinkLayout<ChatLinkType::ITEM>
+{
+	// Count, then a 24 bit item id and a flags byte saying which optional ids follow
+	static constexpr size_t countOffset = 0;
+	static constexpr size_t idOffset = 1;
+	static constexpr size_t flagsOffset = 4;
+	static constexpr size_t size = 5;
+
+	static constexpr uint8_t skinFlag = 0x80;
+	static constexpr uint8_t upgrade1Flag = 0x40;
+	static constexpr uint8_t upgrade2Flag = 0x20;
+};
+
+template<>
+struct ChatLinkLayout<ChatLinkType::NPC_TEXT> { static constexpr size_t size = 4; };
+template<>
+struct ChatLinkLayout<ChatLinkType::MAP> { static constexpr size_t size = 4; };
+template<>
+struct ChatLinkLayout<ChatLinkType::SKILL> { static constexpr size_t size = 4; };
+template<>
+struct ChatLinkLayout<ChatLinkType::TRAIT> { static constexpr size_t size = 4; };
+template<>
+struct ChatLinkLayout<ChatLinkType::RECIPE> { static constexpr size_t size = 4; };
+template<>
+struct ChatLinkLayout<ChatLinkType::WARDROBE> { static constexpr size_t size = 4; };
+template<>
+struct ChatLinkLayout<ChatLinkType::OUTFIT> { static constexpr size_t size = 4; };
+
+template<>
+struct ChatLinkLayout<ChatLinkType::PLAYER>
+{
+	// 16 byte account id, then the character name as null-terminated UTF-16LE
+	static constexpr size_t nameOffset = 16;
+	static constexpr size_t size = 16;
+};
+
+template<>
+struct ChatLinkLayout<ChatLinkType::WVW_OBJECTIVE>
+{
+	static constexpr size_t objectiveOffset = 0;
+	static constexpr size_t mapOffset = 4;
+	static constexpr size_t size = 8;
+};
+
+// Non-owning view over a decoded chat link; the bytes must outlive the view
+class ChatLink
+{
+public:
+	ChatLink() = default;
+	// Validates the type byte and the fixed payload size, otherwise the view is left invalid
+	ChatLink(const uint8_t* data, size_t size);
+
+	bool valid() const { return type_ != ChatLinkType::INVALID; }
+	ChatLinkType type() const { return type_; }
+
+	// Id of single-id links (NPC text, map, skill, trait, recipe, wardrobe, outfit) and WvW objectives
+	uint32_t id() const { return ReadU32(0); }
+
+	uint32_t coins() const { return ReadU32(0); }
+
+	uint8_t itemCount() const { return payload_[ChatLinkLayout<ChatLinkType::ITEM>::countOffset]; }
+	uint32_t itemId() const { return ReadU32(ChatLinkLayout<ChatLinkType::ITEM>::idOffset) & 0xFFFFFF; }
+	// Optional item ids return 0 when absent
+	uint32_t itemSkinId() const { return ItemOptionalId(ChatLinkLayout<ChatLinkType::ITEM>::skinFlag); }
+	uint32_t itemUpgrade1Id() const { return ItemOptionalId(ChatLinkLayout<ChatLinkType::ITEM>::upgrade1Flag); }
+	uint32_t itemUpgrade2Id() const { return ItemOptionalId(ChatLinkLayout<ChatLinkType::ITEM>::upgrade2Flag); }
+
+	uint32_t wvwMapId() const { return ReadU32(ChatLinkLayout<ChatLinkType::WVW_OBJECTIVE>::mapOffset); }
+
+	// Copies the player name into out, always null-terminating it; returns the number of characters copied
+	size_t playerName(wchar_t* out, size_t outChars) const;
+
+	// Appends a short UTF-8 description such as "[Skill 5491]" or the player's name
+	void Describe(std::string& out) const;
+
+protected:
+	uint32_t ReadU32(size_t offset) const
+	{
+		return uint32_t(payload_[offset]) | uint32_t(payload_[offset + 1]) << 8 | uint32_t(payload_[offset + 2]) << 16 | uint32_t(payload_[offset + 3]) << 24;
+	}
+	uint32_t ItemOptionalId(uint8_t flag) const;
+
+	ChatLinkType type_ = ChatLinkType::INVALID;
+	const uint8_t* payload_ = nullptr;
+	size_t payloadSize_ = 0;
+};
+
+// Holds the decoded bytes a ChatLink points into
+struct ChatLinkBuffer
+{
+	// Longer links are truncated, which will fail validation for anything but an overlong player name
+	static constexpr size_t MaxEncodedLength = 512;
+
+	std::array<uint8_t, Base64DecodedSize(MaxEncodedLength)> bytes;
+	size_t size = 0;
+};
+
+// Decodes the base64 text between "[&" and "]" into buffer and returns a view over it
+ChatLink DecodeChatLink(std::wstring_view encoded, ChatLinkBuffer& buffer);
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <Platform.h>
+#include <ChatMessage.h>
+
+namespace GW2Radial
+{
+
+// Retained chat messages, oldest first, bounded by line count, age and text size.
+// Records live in a fixed ring of slots; evicted slots keep their string buffers
+// and are reused for later messages, so memory stays flat once the ring is full.
+class ChatLog
+{
+public:
+	struct Limits
+	{
+		size_t maxLines;
+		mstime maxAge; // In milliseconds, 0 to keep messages forever
+		size_t maxBytes;
+	};
+
+	explicit ChatLog(const Limits& limits);
+
+	const Limits& limits() const { return limits_; }
+	void limits(const Limits& limits);
+
+	size_t size() const { return count_; }
+	// Retained messages have consecutive serials, so no two of them share serial() % capacity()
+	size_t capacity() const { return slots_.size(); }
+	bool empty() const { return count_ == 0; }
+	size_t bytes() const { return bytes_; }
+	uint64_t evicted() const { return evicted_; }
+
+	// Index 0 is the oldest retained message
+	const ChatMessage& operator[](size_t i) const { return slots_[(first_ + i) % slots_.size()]; }
+
+	// Parses raw into a recycled slot, evicting old messages as needed; returns false if the line was not a chat message
+	bool Append(std::wstring_view raw, mstime time);
+	// Evicts messages older than the maximum age; only ever looks past the oldest message if it has to evict it
+	void Prune(mstime now);
+
+protected:
+	void EvictOldest();
+
+	Limits limits_;
+	std::vector<ChatMessage> slots_;
+	size_t first_ = 0;
+	size_t count_ = 0;
+	size_t bytes_ = 0;
+	uint64_t evicted_ = 0;
+	uint64_t nextSerial_ = 1;
+};
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <Platform.h>
+#include <string_view>
+
+namespace GW2Radial
+{
+
+// A single chat line, parsed once when it is taken off the ingest queue.
+// The rendered text is stored as "sender: body" in UTF-8 so the frame path can hand it to ImGui as is.
+class ChatMessage
+{
+public:
+	const std::string& text() const { return text_; }
+	std::string_view sender() const { return std::string_view(text_).substr(0, senderLength_); }
+	std::string_view body() const { return std::string_view(text_).substr(bodyOffset_); }
+	mstime time() const { return time_; }
+	// Assigned by ChatLog in arrival order starting from 1, so it identifies a message across slot reuse
+	uint64_t serial() const { return serial_; }
+
+protected:
+	// Empties the record but keeps its buffer around for the next message parsed into it
+	void Recycle() { text_.clear(); senderLength_ = bodyOffset_ = 0; time_ = 0; serial_ = 0; }
+
+	std::string text_;
+	size_t senderLength_ = 0;
+	size_t bodyOffset_ = 0;
+	mstime time_ = 0;
+	uint64_t serial_ = 0;
+
+	friend bool ParseChatMessage(std::wstring_view raw, ChatMessage& out);
+	friend class ChatLog;
+};
+
+// Splits a raw chat line into its base64 sender link and its body following the
+// <quote>[&link]: body grammar, matching what .*quote>\[&(.*)\]: (.*)$ would capture.
+// Runs in linear time, never allocates and returns views into raw.
+bool ScanChatQuote(std::wstring_view raw, std::wstring_view& link, std::wstring_view& body);
+
+// Parses a raw chat line as sent by textHook, e.g.
+// <quote>[&CGFMngACJRHqgbaVEDwNZJJNAGkAeQB1AGsAaQBuAHkAYQAAAA==]: message text
+// Returns false if the line does not carry a sender and a body, in which case out is left untouched.
+bool ParseChatMessage(std::wstring_view raw, ChatMessage& out);
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <Platform.h>
+#include <ChatLog.h>
+#include <imgui.h>
+
+namespace GW2Radial
+{
+
+// Draws a ChatLog into the current ImGui window.
+// Only the lines within the window's scroll region are submitted, and each line's glyph quads
+// are laid out once and cached relative to the line's origin, so a line which is still on
+// screen next frame is emitted by copying its vertices instead of going through ImFont again.
+class ChatView
+{
+public:
+	void Draw(const ChatLog& log);
+	// Must be called whenever the font atlas may have been rebuilt, since cached quads hold its UVs
+	void Invalidate();
+
+	uint64_t cacheMisses() const { return cacheMisses_; }
+
+protected:
+	struct Line
+	{
+		uint64_t serial = 0;
+		float width = 0.f;
+		// Four vertices per glyph in RenderText's order, sorted by x
+		std::vector<ImDrawVert> vertices;
+	};
+
+	const Line& CachedLine(const ChatMessage& message);
+	void DrawLine(const Line& line);
+
+	std::vector<Line> lines_;
+
+	// Cached quads are only valid for this font, size and colour
+	const ImFont* font_ = nullptr;
+	float fontSize_ = 0.f;
+	ImU32 color_ = 0;
+
+	std::unique_ptr<ImDrawList> scratch_;
+	uint64_t cacheMisses_ = 0;
+};
+
+}
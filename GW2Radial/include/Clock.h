@@ -0,0 +1,51 @@
+#pragma once
+#include <Platform.h>
+#include <atomic>
+
+namespace GW2Radial
+{
+
+// Monotonic tick count at a fixed rate; Clock::system() is the performance counter, replays and tests supply their own
+class ClockSource
+{
+public:
+	virtual ~ClockSource() = default;
+	virtual int64_t ticks() const = 0;
+	virtual int64_t ticksPerSecond() const = 0;
+};
+
+// Monotonic time with the counter frequency read only once, plus a snapshot taken at the
+// start of every frame so everything drawn in that frame agrees on the time without asking the OS.
+// Frame time is only advanced by the render thread; other threads should use the live readings.
+// All readings come from the performance counter unless a thread installs a source of its own.
+class Clock
+{
+public:
+	static int64_t microseconds();
+	static mstime milliseconds() { return mstime(microseconds() / 1000); }
+
+	static void BeginFrame() { frameMicroseconds_.store(microseconds(), std::memory_order_relaxed); }
+	static int64_t frameMicroseconds() { return frameMicroseconds_.load(std::memory_order_relaxed); }
+	static mstime frameMilliseconds() { return mstime(frameMicroseconds() / 1000); }
+
+	// The performance counter as a ClockSource, for code which takes its clock as a parameter
+	static const ClockSource& system();
+
+	// What microseconds() and so frame time read on the calling thread; nullptr goes back to system().
+	// Per thread, so a test or a replay can run on a clock of its own while every other thread keeps
+	// real time. Whoever installs one must restore it before the source goes away.
+	static const ClockSource& source();
+	static void source(const ClockSource* source) { source_ = source; }
+
+	// Rescales a tick count without forming ticks * unitsPerSecond, which overflows after long uptimes
+	static constexpr int64_t Convert(int64_t ticks, int64_t ticksPerSecond, int64_t unitsPerSecond)
+	{
+		return ticks / ticksPerSecond * unitsPerSecond + ticks % ticksPerSecond * unitsPerSecond / ticksPerSecond;
+	}
+
+protected:
+	static std::atomic<int64_t> frameMicroseconds_;
+	static thread_local const ClockSource* source_;
+};
+
+}
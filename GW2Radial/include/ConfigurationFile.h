@@ -20,6 +20,7 @@ public:
 	void lastSaveErrorChanged(bool v) { lastSaveErrorChanged_ = v; lastSaveError_.clear(); }
 
 	CSimpleIniA& ini() { return ini_; }
+	const std::wstring& folder() const { return folder_; }
 
 protected:
 	static std::tuple<bool /*exists*/, bool /*writable*/> CheckFolder(const std::wstring& folder);
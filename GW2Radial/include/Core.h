@@ -4,7 +4,10 @@
 #include <Singleton.h>
 #include <Wheel.h>
 #include <UnitQuad.h>
-#include <queue>
+#include <ChatIngestQueue.h>
+#include <ChatLog.h>
+#include <ChatDedup.h>
+#include <ChatView.h>
 
 #define _CRT_SECURE_NO_WARNINGS
 
@@ -32,12 +35,24 @@ public:
 	ImFont* fontItalic() const { return fontItalic_; }
 
 	void DrawTextDatas();
+#ifdef GW2RADIAL_INPUT_RECORDER
+	void DrawInputRecorder();
+#endif
 	void InsertTextData(wchar_t* val);
 
+	using ChatQueue = ChatIngestQueue<256, 512>;
+	const ChatQueue& chatQueue() const { return chatQueue_; }
+
 protected:
-	std::queue<wchar_t*> textDataMap;
-	DWORD lastRemTime = 0;
-	CRITICAL_SECTION cs;
+	void IngestTextData(const std::wstring& raw, mstime time);
+
+	// Created along with the device, since its limits come from the configuration file
+	std::unique_ptr<ChatLog> chatLog_;
+	std::unique_ptr<ChatDedup> chatDedup_;
+	ChatView chatView_;
+
+	// Filled by the game's chat thread, drained by the render thread
+	ChatQueue chatQueue_;
 
 	void InternalInit();
 	void OnFocusLost();
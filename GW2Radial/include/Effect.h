@@ -1,6 +1,7 @@
 #pragma once
 
-#include "Main.h"
+#include <Main.h>
+#include <array>
 
 namespace GW2Radial {
 
@@ -20,9 +21,10 @@ typedef enum EffectVarSlot {
 	EFF_VS_SPRITE_DIM,
 	EFF_VS_HOVER_FADEINS,
 	EFF_VS_SCREEN_SIZE,
-	EFF_VS_ELEMENT_ID,
+	EFF_VS_ELEMENT_PARAMS,
 	EFF_VS_ELEMENT_COLOR,
-	EFF_VS_TECH_ID
+	EFF_VS_TECH_ID,
+	EFF_VS_ELEMENT_UV_RECT
 } EffectVarSlot;
 
 typedef enum EffectTextureSlot {
@@ -47,6 +49,10 @@ public:
 
 	virtual void SetTexture(EffectTextureSlot slot, IDirect3DTexture9* val);
 
+	// True if elements can be drawn with the instanced vertex shader, otherwise they are drawn one at a time from the EFF_VS_ELEMENT_* variables
+	virtual bool instancing() const { return vsInstanced != nullptr; }
+	void SetInstanced(bool enabled);
+
 	virtual void SceneBegin(void* drawBuf);
 	virtual void SceneEnd();
 
@@ -55,12 +61,36 @@ public:
 	virtual void EndPass();
 	virtual void End();
 
-	void SetVarToSlot(EffectVarSlot slot, float* mem, int sz);
+	// sz is in bytes; regOffset selects a later register of an array variable
+	void SetVarToSlot(EffectVarSlot slot, float* mem, int sz, int regOffset = 0);
+	// Uploads the variables set since the last commit; BeginPass does this, variables set inside a pass need it before drawing
+	void CommitChanges();
 
 protected:
+	// Shadow copy of the shader constant registers the variables live in. Setting a variable only writes here;
+	// CommitChanges then uploads registers which changed, or were not uploaded since SceneBegin, one contiguous run at a time.
+	struct ConstantRegisters
+	{
+		static constexpr uint Count = 20;
+
+		std::array<float, Count * 4> values { };
+		uint32_t dirty = 0;
+		uint32_t uploaded = 0;
+
+		void Write(uint reg, const float* data, uint floatCount);
+	};
+
+	void CommitChanges(ConstantRegisters& regs, bool vertexShader);
+	// Sets every state the effect changes, to record them into the state block
+	void RecordTouchedStates();
+	// The game uses the same registers between our scenes, so nothing uploaded before can be assumed to still be there
+	void InvalidateConstants() { vsConsts.uploaded = psConsts.uploaded = 0; }
+
 	IDirect3DDevice9* dev;
 	IDirect3DPixelShader9* ps;
 	IDirect3DVertexShader9* vs;
+	IDirect3DVertexShader9* vsInstanced;
+	ConstantRegisters vsConsts, psConsts;
 
 private:	
 	IDirect3DStateBlock9* sb;
@@ -16,6 +16,9 @@ public:
 
 	void SetTexture(EffectTextureSlot slot, IDirect3DTexture9* val);
 
+	// The pipeline states are compiled for the unit quad's declaration alone
+	bool instancing() const { return false; }
+
 	void SceneBegin(void* drawBuf);
 	void SceneEnd();
 
@@ -2,8 +2,13 @@
 
 #include <Main.h>
 #include <Singleton.h>
-#include <set>
+#include <KeyCombo.h>
+#include <InputDispatcher.h>
+#include <InputScheduler.h>
+#include <InputReplay.h>
 #include <list>
+#include <mutex>
+#include <array>
 #include <functional>
 #include <algorithm>
 #include <optional>
@@ -12,40 +17,17 @@
 namespace GW2Radial
 {
 
-enum class InputResponse : uint
-{
-	PASS_TO_GAME = 0, // Do not prevent any input from reaching the game
-	PREVENT_MOUSE = 1, // Prevent mouse movement only from reaching the game
-	PREVENT_ALL = 2 // Prevent all input from reaching the game
-};
-
-struct EventKey
-{
-	uint vk : 31;
-	bool down : 1;
-};
-
 struct Point
 {
 	int x;
 	int y;
 };
 
-inline InputResponse operator|(InputResponse a, InputResponse b)
-{
-	return InputResponse(std::max(uint(a), uint(b)));
-}
-
-inline InputResponse operator|=(InputResponse& a, InputResponse b)
-{
-	return (a = a | b);
-}
-
 class Input : public Singleton<Input>
 {
 public:
-	using MouseMoveCallback = std::function<bool()>;
-	using InputChangeCallback = std::function<InputResponse(bool changed, const std::set<uint>& keys, const std::list<EventKey>& changedKeys)>;
+	using MouseMoveCallback = InputDispatcher::MouseMoveCallback;
+	using InputChangeCallback = InputDispatcher::InputChangeCallback;
 	Input();
 
 	uint id_H_LBUTTONDOWN() const { return id_H_LBUTTONDOWN_; }
@@ -62,29 +44,23 @@ public:
 	// Returns true to consume message
 	bool OnInput(UINT& msg, WPARAM& wParam, LPARAM& lParam);
 	void OnFocusLost();
-	void OnUpdate();
 	
-	void AddMouseMoveCallback(MouseMoveCallback* cb) { mouseMoveCallbacks_.push_back(cb); }
-	void AddInputChangeCallback(InputChangeCallback* cb) { inputChangeCallbacks_.push_back(cb); }
-	void RemoveMouseMoveCallback(MouseMoveCallback* cb) { mouseMoveCallbacks_.remove(cb); }
-	void RemoveInputChangeCallback(InputChangeCallback* cb) { inputChangeCallbacks_.remove(cb); }
-	void SendKeybind(const std::set<uint> &vkeys, std::optional<Point> const& cursorPos = { });
+	// Must not be called from inside a callback
+	void AddMouseMoveCallback(MouseMoveCallback* cb);
+	void AddInputChangeCallback(InputChangeCallback* cb);
+	void RemoveMouseMoveCallback(MouseMoveCallback* cb);
+	void RemoveInputChangeCallback(InputChangeCallback* cb);
+	void SendKeybind(const KeyCombo &vkeys, std::optional<Point> const& cursorPos = { });
+
+	// Runs recorded messages through the live callbacks, so the wheels and settings menu react to them as
+	// they would have, on the calling thread, which should not be the window's. Keybinds they send end up
+	// in the report. Live input skips the callbacks until the replay is done, and the held keys are reset.
+	InputReplay::Report Replay(const std::vector<InputRecord>& records);
 
 protected:
-	struct DelayedInput
-	{
-		uint msg;
-		WPARAM wParam;
-		LPARAM lParam;
-
-		mstime t;
-		std::optional<Point> cursorPos;
-	};
-
 	uint ConvertHookedMessage(uint msg) const;
-	DelayedInput TransformVKey(uint vk, bool down, mstime t, const std::optional<Point>& cursorPos);
+	InputScheduler::Message TransformVKey(uint vk, bool down, int64_t due, const std::optional<Point>& cursorPos);
 	std::tuple<WPARAM, LPARAM> CreateMouseEventParams(const std::optional<Point>& cursorPos) const;
-	void SendQueuedInputs();
 
 	// ReSharper disable CppInconsistentNaming
 	uint id_H_LBUTTONDOWN_;
@@ -102,15 +78,17 @@ protected:
 	uint id_H_MOUSEMOVE_;
 	// ReSharper restore CppInconsistentNaming
 
-	std::set<uint> DownKeys;
-	std::list<DelayedInput> QueuedInputs;
-	
-	std::list<MouseMoveCallback*> mouseMoveCallbacks_;
-	std::list<InputChangeCallback*> inputChangeCallbacks_;
+	InputDispatcher dispatcher_;
+	InputScheduler scheduler_;
+
+	// Held whenever callbacks run, live or replayed, and while the lists of them change
+	std::mutex dispatchMutex_;
+	InputReplay* replay_ = nullptr;
 	
 	ConfigurationOption<bool> distinguishLeftRight_;
 
 	friend class MiscTab;
+	friend class InputRecorder;
 };
 
 }
@@ -0,0 +1,95 @@
+#pragma once
+#include <Platform.h>
+#include <KeyCombo.h>
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <vector>
+
+namespace GW2Radial
+{
+
+enum class InputResponse : uint
+{
+	PASS_TO_GAME = 0, // Do not prevent any input from reaching the game
+	PREVENT_MOUSE = 1, // Prevent mouse movement only from reaching the game
+	PREVENT_ALL = 2 // Prevent all input from reaching the game
+};
+
+inline InputResponse operator|(InputResponse a, InputResponse b)
+{
+	return InputResponse(std::max(uint(a), uint(b)));
+}
+
+inline InputResponse operator|=(InputResponse& a, InputResponse b)
+{
+	return (a = a | b);
+}
+
+struct EventKey
+{
+	uint vk : 31;
+	bool down : 1;
+};
+
+// Key events generated by a single window message, stored inline so handling a message never allocates.
+// No message produces more than two: system key messages also report the Alt state.
+class EventKeys
+{
+public:
+	static constexpr size_t Capacity = 2;
+
+	void push_back(const EventKey& k) { if (size_ < Capacity) keys_[size_++] = k; }
+
+	const EventKey* begin() const { return keys_.data(); }
+	const EventKey* end() const { return keys_.data() + size_; }
+	bool empty() const { return size_ == 0; }
+	size_t size() const { return size_; }
+
+protected:
+	std::array<EventKey, Capacity> keys_ { };
+	size_t size_ = 0;
+};
+
+// The part of input handling which only depends on the messages themselves: turns them into key events,
+// tracks which keys are held down and runs the callbacks. It knows nothing of the game window or ImGui,
+// so recorded messages can be run through an instance of their own, and it never allocates per message.
+class InputDispatcher
+{
+public:
+	using MouseMoveCallback = std::function<bool()>;
+	using InputChangeCallback = std::function<InputResponse(bool changed, const KeyCombo& keys, const EventKeys& changedKeys)>;
+
+	// Key events of a window message; with distinguishLeftRight, Shift, Ctrl and Alt become their left or right key
+	static EventKeys Translate(uint msg, uintptr_t wParam, intptr_t lParam, bool distinguishLeftRight);
+
+	// Applies a message's key events to the held keys and runs the callbacks which care about it.
+	// Callers only need to work out mouseMoved when wantsMouseMoves(), since telling raw mouse input apart costs a system call.
+	// A mouse move callback asking for the mouse to be blocked counts as PREVENT_MOUSE.
+	InputResponse Dispatch(const EventKeys& eventKeys, bool mouseMoved);
+
+	bool wantsMouseMoves() const { return !mouseMoveCallbacks_.empty(); }
+	const KeyCombo& downKeys() const { return downKeys_; }
+	void ClearDownKeys() { downKeys_.clear(); }
+
+	// Callbacks are not owned and must be removed before they are destroyed
+	void AddMouseMoveCallback(MouseMoveCallback* cb) { mouseMoveCallbacks_.push_back(cb); }
+	void AddInputChangeCallback(InputChangeCallback* cb) { inputChangeCallbacks_.push_back(cb); }
+	void RemoveMouseMoveCallback(MouseMoveCallback* cb) { mouseMoveCallbacks_.erase(std::remove(mouseMoveCallbacks_.begin(), mouseMoveCallbacks_.end(), cb), mouseMoveCallbacks_.end()); }
+	void RemoveInputChangeCallback(InputChangeCallback* cb) { inputChangeCallbacks_.erase(std::remove(inputChangeCallbacks_.begin(), inputChangeCallbacks_.end(), cb), inputChangeCallbacks_.end()); }
+	// Adds every callback of other, in the same order, so a replay can run them on keys of its own
+	void AddCallbacks(const InputDispatcher& other)
+	{
+		mouseMoveCallbacks_.insert(mouseMoveCallbacks_.end(), other.mouseMoveCallbacks_.begin(), other.mouseMoveCallbacks_.end());
+		inputChangeCallbacks_.insert(inputChangeCallbacks_.end(), other.inputChangeCallbacks_.begin(), other.inputChangeCallbacks_.end());
+	}
+
+protected:
+	KeyCombo downKeys_;
+
+	// Kept contiguous since they are walked on every input message
+	std::vector<MouseMoveCallback*> mouseMoveCallbacks_;
+	std::vector<InputChangeCallback*> inputChangeCallbacks_;
+};
+
+}
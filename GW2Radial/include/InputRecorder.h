@@ -0,0 +1,65 @@
+#pragma once
+#include <Main.h>
+
+// Only compiled in when GW2RADIAL_INPUT_RECORDER is defined (Debug builds), since recordings hold
+// every key pressed while they run; release builds have neither the recorder nor its menu.
+#ifdef GW2RADIAL_INPUT_RECORDER
+
+#include <Singleton.h>
+#include <Clock.h>
+#include <InputReplay.h>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace GW2Radial
+{
+
+// Records the window messages reaching Core::WndProc to a binary file (see InputReplay.h for the format)
+// and replays such a file through the live input callbacks (see Input::Replay) on a thread of its own.
+// Replays report how long each message took to process, so an input sequence can be reproduced and
+// timed without anyone at the keyboard.
+class InputRecorder : public Singleton<InputRecorder>
+{
+public:
+	using Report = InputReplay::Report;
+
+	~InputRecorder();
+
+	bool Start(const std::wstring& path);
+	void Stop();
+	bool recording() const { return recording_.load(std::memory_order_relaxed); }
+	size_t recordedCount() const { return recordedCount_.load(std::memory_order_relaxed); }
+
+	// Called from the window procedure for every message, before it is handled
+	void Record(uint msg, WPARAM wParam, LPARAM lParam);
+
+	// Starts a replay on a worker thread, unless one is running already
+	void StartReplay(const std::wstring& path);
+	bool replaying() const { return replaying_.load(std::memory_order_relaxed); }
+	Report lastReport() const;
+
+	void DrawMenu();
+
+protected:
+	static constexpr size_t FlushThreshold = 4096;
+
+	void Flush();
+	Report Replay(const std::wstring& path);
+
+	mutable std::mutex mutex_;
+
+	std::atomic<bool> recording_ { false };
+	FILE* file_ = nullptr;
+	int64_t recordStart_ = 0;
+	std::vector<InputRecord> buffer_;
+	std::atomic<size_t> recordedCount_ { 0 };
+
+	std::atomic<bool> replaying_ { false };
+	Report lastReport_;
+};
+
+}
+
+#endif
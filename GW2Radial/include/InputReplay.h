@@ -0,0 +1,102 @@
+#pragma once
+#include <Platform.h>
+#include <Clock.h>
+#include <InputDispatcher.h>
+#include <array>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+namespace GW2Radial
+{
+
+// Format of the files InputRecorder writes: a RecordingHeader followed by InputRecords, little endian.
+// Messages we generate ourselves are stored as the standard message they stand in for and flagged Synthetic;
+// replays skip them since the replayed input produces its own. Only messages a replay acts on are stored
+// (see InputReplay::Replayable), so neither typed text nor raw input ends up on disk.
+struct RecordingHeader
+{
+	char magic[4];
+	uint32_t version;
+
+	static constexpr uint32_t Version = 1;
+	static constexpr char Magic[4] = { 'G', 'R', 'I', 'R' };
+};
+
+struct InputRecord
+{
+	enum Flags : uint32_t
+	{
+		Synthetic = 1
+	};
+
+	uint64_t time; // Microseconds since recording started
+	uint32_t msg;
+	uint32_t flags;
+	uint64_t wParam;
+	uint64_t lParam;
+};
+
+// Time which only moves when told to, in microseconds
+class SimulatedClock : public ClockSource
+{
+public:
+	int64_t ticks() const override { return microseconds; }
+	int64_t ticksPerSecond() const override { return 1000000; }
+
+	int64_t microseconds = 0;
+};
+
+// Runs recorded messages through an InputDispatcher of its own, so the live held keys are not touched,
+// under a simulated clock set to each message's recorded time. While Run is going, that clock is the
+// running thread's Clock::source() and running() returns the replay, which is how Input::SendKeybind
+// knows to hand keybinds to SendKeybind, which notes them in the report instead of sending them.
+// Callbacks are added to dispatcher(), either the live ones (see Input::Replay) or test stand-ins.
+// Reports how long each message took to handle, which is wall clock time, unlike everything else here.
+class InputReplay
+{
+public:
+	struct SentKey
+	{
+		mstime time; // Simulated milliseconds since the recording started
+		uint vk;
+		bool down;
+	};
+
+	struct Report
+	{
+		std::wstring error;
+		size_t messages = 0;
+		size_t recordedSynthetic = 0;
+		// Bucket 0 counts messages handled in under 1 us, bucket i those under 2^i us, the last everything slower
+		std::array<size_t, 16> histogram { };
+		double p50 = 0, p99 = 0, max = 0; // Microseconds
+		std::vector<SentKey> sentKeys;
+	};
+
+	explicit InputReplay(bool distinguishLeftRight) : distinguishLeftRight_(distinguishLeftRight) { }
+
+	// Reads a whole recording; false if fp does not hold one
+	static bool Load(FILE* fp, std::vector<InputRecord>& records);
+	// Whether Run does anything with msg, after hooked messages are converted back; the recorder keeps only these
+	static bool Replayable(uint msg);
+
+	// The replay Run is going on the calling thread, if any
+	static InputReplay* running();
+
+	InputDispatcher& dispatcher() { return dispatcher_; }
+	const ClockSource& clock() const { return clock_; }
+
+	void SendKeybind(const KeyCombo& keys);
+
+	// Callbacks run with dispatchLock held, if given, so they never overlap with another thread using them
+	Report Run(const std::vector<InputRecord>& records, std::mutex* dispatchLock = nullptr);
+
+protected:
+	bool distinguishLeftRight_;
+	SimulatedClock clock_;
+	InputDispatcher dispatcher_;
+	std::vector<SentKey> sentKeys_;
+};
+
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <Platform.h>
+#include <Clock.h>
+#include <KeyCombo.h>
+#include <functional>
+#include <mutex>
+#include <queue>
+
+namespace GW2Radial
+{
+
+// Sends window messages at given deadlines from its own thread, independently of the frame rate.
+// Pending messages sit in a min-heap ordered by deadline, then by scheduling order, and the
+// thread sleeps on a waitable timer set for the earliest one.
+// Deadlines are ticks of the clock given on construction. It is read again whenever the thread wakes,
+// so a timer firing ahead of time, or one with coarser resolution than the clock, never sends early.
+class InputScheduler
+{
+public:
+	struct Message
+	{
+		void* window;
+		uint msg;
+		uintptr_t wParam;
+		intptr_t lParam;
+		int64_t due; // In ticks of the scheduler's clock
+	};
+
+	// Called on the scheduler thread with its queue locked, so it must not call back into the scheduler
+	using Sender = std::function<void(const Message&)>;
+
+	// The clock must outlive the scheduler
+	InputScheduler(const ClockSource& clock, Sender sender);
+	~InputScheduler();
+	InputScheduler(const InputScheduler&) = delete;
+	InputScheduler& operator=(const InputScheduler&) = delete;
+
+	// Thread safe; messages with the same deadline are sent in the order they were scheduled
+	void Schedule(const Message& m);
+	void Clear();
+	bool empty() const;
+
+	const ClockSource& clock() const { return *state_->clock; }
+
+	// Sends every message due by the clock's current time and returns how long until the next one is,
+	// in the 100 ns units WaitableTimer takes and rounded up, or -1 if none is left.
+	// The scheduler thread calls this whenever it wakes; with a clock that only moves when told to,
+	// calling it after each step drives the scheduler without depending on how the thread is scheduled.
+	int64_t SendDue();
+
+	// How a keybind is typed: modifiers go down first and come up last, other keys in key code order.
+	// The first key goes down 10 ms after now, the rest 20 ms apart, and the whole chord is held for 50 ms more.
+	// Calls step for every key event with its deadline in ticks of clock.
+	using KeyStep = std::function<void(uint vk, bool down, int64_t due)>;
+	static void SequenceKeybind(const KeyCombo& keys, const ClockSource& clock, const KeyStep& step);
+
+protected:
+	struct Entry
+	{
+		Message message;
+		uint64_t sequence;
+
+		bool operator>(const Entry& other) const
+		{
+			return message.due != other.message.due ? message.due > other.message.due : sequence > other.sequence;
+		}
+	};
+
+	// Shared with the thread, which may outlive the scheduler since it is never joined:
+	// joining from a destructor run under the loader lock would deadlock
+	struct State
+	{
+		std::mutex mutex;
+		std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> pending;
+		uint64_t nextSequence = 0;
+		bool stop = false;
+
+		const ClockSource* clock;
+		Sender sender;
+		WaitableTimer timer;
+	};
+
+	// False once the scheduler has been destroyed
+	static bool SendDue(State& state, int64_t& delay);
+	static void Run(std::shared_ptr<State> state);
+
+	std::shared_ptr<State> state_;
+};
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <Main.h>
+#include <d3d9.h>
+#include <Effect.h>
+
+namespace GW2Radial
+{
+
+// Per instance data read by Shader_instanced_vs, laid out like the EFF_VS_ELEMENT_* variables
+struct QuadInstance
+{
+	fVector4 spriteDimensions;
+	fVector4 uvRect;
+	fVector4 color;
+	fVector4 params;
+};
+
+// Draws many copies of a UnitQuad in a single call, using stream frequency instancing:
+// the quad's corners come from stream 0 and one QuadInstance per copy from stream 1.
+class InstancedQuad
+{
+public:
+	InstancedQuad(IDirect3DDevice9* device, uint capacity);
+	InstancedQuad(const InstancedQuad& iq) = delete;
+	InstancedQuad& operator=(InstancedQuad iq) = delete;
+	InstancedQuad(InstancedQuad&& iq) = delete;
+	InstancedQuad& operator=(InstancedQuad&& iq) = delete;
+	~InstancedQuad();
+
+	uint capacity() const { return capacity_; }
+	static uint stride() { return sizeof(QuadInstance); }
+
+	static const D3DVERTEXELEMENT9* def();
+
+	// Replaces the buffer's contents with count instances, which must not exceed capacity
+	bool Upload(const QuadInstance* instances, uint count);
+
+	void Bind(const class UnitQuad& quad) const;
+	void Draw(uint firstInstance, uint instanceCount) const;
+	// Restores the stream frequencies and the quad's own declaration, so plain UnitQuad draws work again
+	void Unbind(const class UnitQuad& quad) const;
+
+	// Draws count quads through fx, each with its own instance data and texture. Runs of consecutive quads sharing a texture
+	// take one draw each when instances is given and the effect can instance, otherwise every quad takes its own draw.
+	static void DrawAll(Effect* fx, const class UnitQuad& quad, InstancedQuad* instances, const QuadInstance* data, IDirect3DTexture9* const* textures, uint count);
+
+private:
+	IDirect3DDevice9* device_ = nullptr;
+	IDirect3DVertexDeclaration9* vertexDeclaration_ = nullptr;
+	IDirect3DVertexBuffer9* buffer_ = nullptr;
+	uint capacity_ = 0;
+};
+
+}
@@ -0,0 +1,227 @@
+#pragma once
+#include <Platform.h>
+#include <array>
+#include <charconv>
+#include <initializer_list>
+#include <iterator>
+#include <string_view>
+#include <utility>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace GW2Radial
+{
+
+// Set of virtual keys stored as a 256 bit mask, so comparing, intersecting and
+// testing one combination against another is a handful of word operations.
+// Mirrors the parts of std::set<uint> the input code used; iteration is in ascending key order.
+// Keys outside [0, KeyCount) can never be members and are ignored by insert().
+class KeyCombo
+{
+	static constexpr uint WordBits = 64;
+	static constexpr uint WordCount = 4;
+
+public:
+	static constexpr uint KeyCount = WordBits * WordCount;
+
+	class iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = uint;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const uint*;
+		using reference = uint;
+
+		iterator() = default;
+
+		uint operator*() const { return vk_; }
+		iterator& operator++() { vk_ = combo_->Next(vk_ + 1); return *this; }
+		iterator operator++(int) { auto it = *this; ++*this; return it; }
+
+		bool operator==(const iterator& other) const { return vk_ == other.vk_; }
+		bool operator!=(const iterator& other) const { return vk_ != other.vk_; }
+
+	protected:
+		iterator(const KeyCombo* combo, uint vk) : combo_(combo), vk_(vk) { }
+
+		const KeyCombo* combo_ = nullptr;
+		uint vk_ = KeyCount;
+
+		friend class KeyCombo;
+	};
+	using const_iterator = iterator;
+	using value_type = uint;
+
+	KeyCombo() = default;
+	KeyCombo(std::initializer_list<uint> keys)
+	{
+		for (auto vk : keys)
+			insert(vk);
+	}
+	template<typename It>
+	KeyCombo(It first, It last)
+	{
+		for (; first != last; ++first)
+			insert(*first);
+	}
+
+	iterator begin() const { return { this, Next(0) }; }
+	iterator end() const { return { this, KeyCount }; }
+
+	bool empty() const { return (words_[0] | words_[1] | words_[2] | words_[3]) == 0; }
+	size_t size() const { return PopCount(words_[0]) + PopCount(words_[1]) + PopCount(words_[2]) + PopCount(words_[3]); }
+	size_t count(uint vk) const { return vk < KeyCount && (words_[vk / WordBits] >> vk % WordBits & 1) ? 1 : 0; }
+
+	std::pair<iterator, bool> insert(uint vk)
+	{
+		if (vk >= KeyCount)
+			return { end(), false };
+
+		auto& w = words_[vk / WordBits];
+		const auto bit = uint64_t(1) << vk % WordBits;
+		const bool inserted = (w & bit) == 0;
+		w |= bit;
+		return { { this, vk }, inserted };
+	}
+	size_t erase(uint vk)
+	{
+		if (!count(vk))
+			return 0;
+		words_[vk / WordBits] &= ~(uint64_t(1) << vk % WordBits);
+		return 1;
+	}
+	void clear() { words_ = { }; }
+
+	// True if every key of other is also in this combination
+	bool includes(const KeyCombo& other) const
+	{
+		return ((other.words_[0] & ~words_[0]) | (other.words_[1] & ~words_[1]) | (other.words_[2] & ~words_[2]) | (other.words_[3] & ~words_[3])) == 0;
+	}
+	bool intersects(const KeyCombo& other) const
+	{
+		return ((other.words_[0] & words_[0]) | (other.words_[1] & words_[1]) | (other.words_[2] & words_[2]) | (other.words_[3] & words_[3])) != 0;
+	}
+
+	KeyCombo& operator|=(const KeyCombo& other) { for (uint i = 0; i < WordCount; i++) words_[i] |= other.words_[i]; return *this; }
+	KeyCombo& operator&=(const KeyCombo& other) { for (uint i = 0; i < WordCount; i++) words_[i] &= other.words_[i]; return *this; }
+	KeyCombo& operator-=(const KeyCombo& other) { for (uint i = 0; i < WordCount; i++) words_[i] &= ~other.words_[i]; return *this; }
+	friend KeyCombo operator|(KeyCombo a, const KeyCombo& b) { return a |= b; }
+	friend KeyCombo operator&(KeyCombo a, const KeyCombo& b) { return a &= b; }
+	friend KeyCombo operator-(KeyCombo a, const KeyCombo& b) { return a -= b; }
+
+	bool operator==(const KeyCombo& other) const { return words_ == other.words_; }
+	bool operator!=(const KeyCombo& other) const { return words_ != other.words_; }
+
+	const std::array<uint64_t, WordCount>& words() const { return words_; }
+
+	// Configuration format: decimal key codes separated by commas, e.g. "17, 65"
+	static constexpr size_t MaxSerializedLength = KeyCount * 5 - 2;
+	using SerializedBuffer = std::array<char, MaxSerializedLength + 1>;
+
+	// Replaces keys with those listed in text, ignoring blanks around each entry. Entries which are not a
+	// key code are skipped; returns the offset of the first of those, or npos if there were none.
+	static size_t Parse(std::string_view text, KeyCombo& keys)
+	{
+		keys.clear();
+		if (text.find_first_not_of(" \t") == std::string_view::npos)
+			return std::string_view::npos;
+
+		size_t firstError = std::string_view::npos;
+		for (size_t begin = 0; begin <= text.size();)
+		{
+			auto comma = text.find(',', begin);
+			if (comma == std::string_view::npos)
+				comma = text.size();
+
+			auto first = begin, last = comma;
+			while (first < last && (text[first] == ' ' || text[first] == '\t'))
+				first++;
+			while (last > first && (text[last - 1] == ' ' || text[last - 1] == '\t'))
+				last--;
+
+			uint vk = 0;
+			const auto [end, ec] = std::from_chars(text.data() + first, text.data() + last, vk);
+			if (first == last || ec != std::errc() || end != text.data() + last || vk >= KeyCount)
+			{
+				if (firstError == std::string_view::npos)
+					firstError = first;
+			}
+			else
+				keys.insert(vk);
+
+			begin = comma + 1;
+		}
+
+		return firstError;
+	}
+
+	// Writes the keys in ascending order in the format Parse reads; the result points into out
+	std::string_view Serialize(SerializedBuffer& out) const
+	{
+		char* p = out.data();
+		char* const end = out.data() + MaxSerializedLength;
+		for (auto vk : *this)
+		{
+			if (p != out.data())
+			{
+				*p++ = ',';
+				*p++ = ' ';
+			}
+			p = std::to_chars(p, end, vk).ptr;
+		}
+		*p = '\0';
+
+		return { out.data(), size_t(p - out.data()) };
+	}
+
+protected:
+	// First member key at or after vk, or KeyCount
+	uint Next(uint vk) const
+	{
+		for (uint i = vk / WordBits; i < WordCount; i++)
+		{
+			auto w = words_[i];
+			if (i == vk / WordBits)
+				w &= ~uint64_t(0) << vk % WordBits;
+			if (w)
+				return i * WordBits + LowestBit(w);
+		}
+		return KeyCount;
+	}
+
+	static uint LowestBit(uint64_t w)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward64(&index, w);
+		return uint(index);
+#else
+		return uint(__builtin_ctzll(w));
+#endif
+	}
+
+	static size_t PopCount(uint64_t w)
+	{
+		w = w - (w >> 1 & 0x5555555555555555ull);
+		w = (w & 0x3333333333333333ull) + (w >> 2 & 0x3333333333333333ull);
+		w = (w + (w >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+		return size_t(w * 0x0101010101010101ull >> 56);
+	}
+
+	std::array<uint64_t, WordCount> words_ { };
+};
+
+struct KeyComboHash
+{
+	size_t operator()(const KeyCombo& c) const
+	{
+		uint64_t h = 0;
+		for (auto w : c.words())
+			h = (h ^ w) * 0x9E3779B97F4A7C15ull;
+		return size_t(h ^ h >> 32);
+	}
+};
+
+}
@@ -1,7 +1,7 @@
 #pragma once
-#include <Main.h>
+#include <Platform.h>
+#include <KeyCombo.h>
 #include <array>
-#include <set>
 #include <functional>
 #include <unordered_map>
 
@@ -11,12 +11,12 @@ namespace GW2Radial
 class Keybind
 {
 public:
-	Keybind(std::string nickname, std::string displayName, const std::set<uint>& keys, bool saveToConfig);
+	Keybind(std::string nickname, std::string displayName, const KeyCombo& keys, bool saveToConfig);
 	Keybind(std::string nickname, std::string displayName);
 	~Keybind();
 
-	const std::set<uint>& keys() const { return keys_; }
-	void keys(const std::set<uint>& keys);
+	const KeyCombo& keys() const { return keys_; }
+	void keys(const KeyCombo& keys);
 	void keys(const char* keys);
 
 	const std::string& displayName() const { return displayName_; }
@@ -34,28 +34,36 @@ public:
 	const char* keysDisplayString() const { return keysDisplayString_.data(); }
 	std::array<char, 256>& keysDisplayStringArray() { return keysDisplayString_; }
 
-	bool conflicts(const std::set<uint>& pressedKeys) const;
+	bool conflicts(const KeyCombo& pressedKeys) const;
 	
-	bool matches(const std::set<uint>& pressedKeys) const { return pressedKeys == keys_; }
-	bool matchesPartial(const std::set<uint>& pressedKeys) const
-	{
-		return isSet() && std::includes(pressedKeys.begin(), pressedKeys.end(), keys_.begin(), keys_.end());
-	}
-	bool matchesNoLeftRight(const std::set<uint>& pressedKeys) const;
+	bool matches(const KeyCombo& pressedKeys) const { return pressedKeys == keys_; }
+	bool matchesPartial(const KeyCombo& pressedKeys) const { return isSet() && pressedKeys.includes(keys_); }
+	bool matchesNoLeftRight(const KeyCombo& pressedKeys) const;
+
+	// Reformats every keybind with keys set, for when key names change with the keyboard layout
+	static void UpdateDisplayStrings();
 
 protected:
 	void UpdateDisplayString();
 	void ApplyKeys();
-	void CheckForConflict(bool recurse = true);
+	// Remove from and add back to the registry under the current keys, updating the conflict flags of the affected group only
+	void Unindex();
+	void Index();
 
 	std::string displayName_, nickname_;
 	std::array<char, 256> keysDisplayString_ { };
 	bool isBeingModified_ = true;
-	std::set<uint> keys_;
+	KeyCombo keys_;
 	bool saveToConfig_ = true;
 	bool isConflicted_ = false;
+	KeyCombo indexedKeys_;
+
+	// Every keybind with keys set, grouped by identical keys; any group of two or more is conflicted
+	static std::unordered_map<KeyCombo, std::vector<Keybind*>, KeyComboHash> keybindsByKeys_;
+	// Distinct keys of those groups, bucketed by how many keys they hold
+	static std::vector<std::vector<KeyCombo>> keysBySize_;
 
-	static std::unordered_map<Keybind*, std::set<uint>> keyMaps_;
+	friend class KeybindMatcher;
 };
 
 }
\ No newline at end of file
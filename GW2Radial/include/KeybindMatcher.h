@@ -0,0 +1,47 @@
+#pragma once
+#include <Keybind.h>
+#include <atomic>
+#include <vector>
+
+namespace GW2Radial
+{
+
+// Every registered keybind compiled into one flat list of distinct chords, longest first, so a single
+// pass over the held keys finds the longest chord being held. Keybinds of that length are the winners,
+// which is the same longest-chord-wins rule as Keybind::matchesPartial combined with !Keybind::conflicts.
+// The list is rebuilt only after a keybind changes, and the answer is cached until the held keys change.
+class KeybindMatcher
+{
+public:
+	// Number of keys in the longest keybind held down in pressedKeys, or 0 if none is
+	static size_t longestHeld(const KeyCombo& pressedKeys);
+
+	// True if kb is held down and no longer keybind is
+	static bool wins(const Keybind& kb, const KeyCombo& pressedKeys)
+	{
+		return kb.matchesPartial(pressedKeys) && kb.keys().size() == longestHeld(pressedKeys);
+	}
+
+	static void Invalidate() { dirty_.store(true, std::memory_order_release); }
+
+protected:
+	static void Rebuild();
+	static void Match(const KeyCombo& pressedKeys);
+
+	struct Chord
+	{
+		KeyCombo keys;
+		size_t size;
+	};
+
+	static std::vector<Chord> chords_;
+	// Index of the first chord of at most n keys, so chords longer than what is held are never tested
+	static std::vector<size_t> firstOfSize_;
+	// Set whenever a keybind changes; taken by the next match, so a change made during a rebuild triggers another
+	static std::atomic<bool> dirty_;
+
+	static KeyCombo lastPressed_;
+	static const Chord* lastMatch_;
+};
+
+}
@@ -46,20 +46,14 @@
 #define NOMCX // - Modem Configuration Extensions
 #include <windows.h>
 
-#include <vector>
-#include <string>
-#include <memory>
-
+#include <Platform.h>
 #include <Resource.h>
 
 #define COM_RELEASE(x) { if((x)) { (x)->Release(); (x) = nullptr; } }
 #define NULL_COALESCE(a, b) ((a) != nullptr ? (a) : (b))
 #define SQUARE(x) ((x) * (x))
 
-typedef unsigned char uchar;
-typedef unsigned int uint;
 typedef std::basic_string<TCHAR> tstring;
-typedef unsigned __int64 mstime;
 
 #ifndef HID_USAGE_PAGE_GENERIC
 #define HID_USAGE_PAGE_GENERIC         ((USHORT) 0x01)
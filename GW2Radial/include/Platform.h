@@ -0,0 +1,61 @@
+#pragma once
+// Basic types and the few OS services the platform independent code relies on.
+// Unlike Main.h, this does not pull in windows.h or Direct3D, so headers which only
+// need these (the chat pipeline, for one) can be compiled on their own.
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+
+typedef unsigned char uchar;
+typedef unsigned int uint;
+typedef uint64_t mstime;
+
+namespace GW2Radial
+{
+
+// Convert a wide Unicode string to an UTF8 string
+std::string utf8_encode(const std::wstring &wstr);
+// Convert an UTF8 string to a wide Unicode String
+std::wstring utf8_decode(const std::string &str);
+
+// Display name of a virtual key in the current keyboard layout
+std::wstring GetKeyName(unsigned int virtualKey);
+using KeyNameTable = std::array<std::string, 256>;
+// GetKeyName of every virtual key in UTF8, as of the last RefreshKeyNames (all empty before the first).
+// A refresh publishes a new table, so the one returned stays unchanged for as long as it is held.
+std::shared_ptr<const KeyNameTable> KeyNames();
+// One name from the current table; empty for keys past 255
+std::string KeyName(unsigned int virtualKey);
+// Builds the table behind KeyNames; Core calls it on startup and whenever the keyboard layout changes
+void RefreshKeyNames();
+
+// Monotonic time, only meaningful relative to other calls; see Clock for finer resolution and frame time
+mstime TimeInMilliseconds();
+
+// The OS high resolution counter Clock is built on, and its rate, which is fixed at boot
+int64_t QueryCounter();
+int64_t QueryCounterFrequency();
+
+// Lets a thread sleep until a delay has passed or another thread wakes it, whichever comes first.
+// On Windows this is a waitable timer, high resolution where the system supports it.
+class WaitableTimer
+{
+public:
+	WaitableTimer();
+	~WaitableTimer();
+	WaitableTimer(const WaitableTimer&) = delete;
+	WaitableTimer& operator=(const WaitableTimer&) = delete;
+
+	// The delay is in 100 ns units, the waitable timer's own; a negative one waits for Wake alone.
+	// Waking with no thread waiting makes the next Wait return at once.
+	void Wait(int64_t delay);
+	void Wake();
+
+protected:
+	struct State;
+	std::unique_ptr<State> state_;
+};
+
+}
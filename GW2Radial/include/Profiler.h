@@ -0,0 +1,94 @@
+#pragma once
+#include <Main.h>
+
+// Scoped timing zones, only compiled in when GW2RADIAL_PROFILER is defined (Debug builds).
+// Otherwise PROFILE_SCOPE expands to nothing and none of the profiler code is built.
+#ifdef GW2RADIAL_PROFILER
+
+#include <atomic>
+#include <array>
+
+namespace GW2Radial
+{
+
+class Profiler
+{
+public:
+	struct Event
+	{
+		const char* zone; // Must be a string literal, zones are told apart by address
+		int64_t start;
+		int64_t end;
+	};
+
+	// Times its own lifetime and records it into the calling thread's ring
+	class Scope
+	{
+	public:
+		explicit Scope(const char* zone) : zone_(zone) { QueryPerformanceCounter(reinterpret_cast<LARGE_INTEGER*>(&start_)); }
+		~Scope()
+		{
+			int64_t end;
+			QueryPerformanceCounter(reinterpret_cast<LARGE_INTEGER*>(&end));
+			Record({ zone_, start_, end });
+		}
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	protected:
+		const char* zone_;
+		int64_t start_;
+	};
+
+	static void Record(const Event& e);
+
+	// Window listing p50/p99/max per zone over the last few seconds
+	static void DrawOverlay();
+	// Writes every event still held in the rings as a Chrome trace (chrome://tracing, Perfetto)
+	static bool DumpTrace(const std::wstring& path);
+
+protected:
+	static constexpr size_t EventsPerThread = 16384;
+
+	// One event behind a sequence lock: the sequence is 2 * index + 1 while event number index is being written into
+	// the slot and 2 * index + 2 once it is complete, so a reader can tell a finished event from a torn or newer one
+	struct Slot
+	{
+		std::atomic<size_t> sequence { 0 };
+		std::atomic<const char*> zone { nullptr };
+		std::atomic<int64_t> start { 0 };
+		std::atomic<int64_t> end { 0 };
+	};
+
+	// Only the owning thread writes; readers take the events below written whose slot still holds them, unchanged
+	struct ThreadEvents
+	{
+		uint32_t threadId = 0;
+		std::atomic<size_t> written { 0 };
+		std::array<Slot, EventsPerThread> events;
+	};
+
+	struct Registry;
+	static Registry& registry();
+	static ThreadEvents& LocalEvents();
+
+	struct ThreadEvent
+	{
+		uint32_t threadId;
+		Event event;
+	};
+	static std::vector<ThreadEvent> Snapshot();
+};
+
+}
+
+#define PROFILE_SCOPE_CONCAT_(a, b) a##b
+#define PROFILE_SCOPE_CONCAT(a, b) PROFILE_SCOPE_CONCAT_(a, b)
+#define PROFILE_SCOPE(zone) ::GW2Radial::Profiler::Scope PROFILE_SCOPE_CONCAT(profileScope_, __LINE__)(zone)
+
+#else
+
+#define PROFILE_SCOPE(zone) ((void)0)
+
+#endif
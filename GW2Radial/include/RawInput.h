@@ -0,0 +1,40 @@
+#pragma once
+#include <Platform.h>
+
+namespace GW2Radial
+{
+
+// Same layout and type values as the RAWINPUTHEADER at the start of every raw input packet
+struct RawInputHeader
+{
+	enum Type : uint32_t
+	{
+		Mouse = 0,
+		Keyboard = 1,
+		Hid = 2
+	};
+
+	uint32_t type;
+	uint32_t size; // Of the whole packet, header included
+	uintptr_t device;
+	uintptr_t wParam;
+};
+
+// Where WM_INPUT's lParam handles lead: GetRawInputData in the game, a recorded stream in tests
+class RawInputSource
+{
+public:
+	virtual ~RawInputSource() = default;
+
+	// Copies only the header of the packet behind handle; false if there is no such packet
+	virtual bool Header(uintptr_t handle, RawInputHeader& header) const = 0;
+};
+
+// Whether a WM_INPUT carries mouse input; a packet which cannot be read is not a mouse
+inline bool IsRawInputMouse(const RawInputSource& source, uintptr_t handle)
+{
+	RawInputHeader header;
+	return source.Header(handle, header) && header.type == RawInputHeader::Mouse;
+}
+
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <Main.h>
+#include <d3d9.h>
+#include <AtlasPacker.h>
+#include <vector>
+
+namespace GW2Radial
+{
+
+// Packs textures of the same format side by side into a single texture, so everything drawn from them shares one binding.
+// AtlasPacker decides where each goes and copies every kept mip level of the sources into place.
+class TextureAtlas
+{
+public:
+	// Returns a managed texture holding every source, and the texture coordinates of each source within it,
+	// or nullptr if the sources differ in format, are not lockable or do not fit on this device
+	static IDirect3DTexture9* Create(IDirect3DDevice9* dev, const std::vector<IDirect3DTexture9*>& sources, std::vector<fVector4>& uvRects);
+
+protected:
+	// Texels between an image and the next at the top level; a cell this wide keeps four levels of DXT blocks,
+	// which reach down to an eighth of the images' size, below what a wheel ever draws them at
+	static constexpr uint MaxBorder = 32;
+
+	static bool FormatInfo(D3DFORMAT format, AtlasPacker::Format& info);
+};
+
+}
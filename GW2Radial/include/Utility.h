@@ -5,17 +5,8 @@
 namespace GW2Radial
 {
 
-// Convert a wide Unicode string to an UTF8 string
-std::string utf8_encode(const std::wstring &wstr);
-// Convert an UTF8 string to a wide Unicode String
-std::wstring utf8_decode(const std::string &str);
-
-std::wstring GetKeyName(unsigned int virtualKey);
-
 void SplitFilename(const tstring & str, tstring * folder, tstring * file);
 
-mstime TimeInMilliseconds();
-
 bool FileExists(const TCHAR* path);
 
 int GetShaderFuncLength(const DWORD *pFunction);
@@ -2,10 +2,13 @@
 
 #include <Main.h>
 #include <WheelElement.h>
+#include <WheelLayout.h>
 #include <ConfigurationOption.h>
 #include <SettingsMenu.h>
 
 #include <Input.h>
+#include <atomic>
+#include <memory>
 
 namespace GW2Radial
 {
@@ -36,6 +39,7 @@ public:
 		// TODO: Would be nice to somehow let wheel element .cpps determine these parameters as well
 		auto wheel = std::make_unique<Wheel>(bgResourceId, inkResourceId, std::move(nickname), std::move(displayName), dev);
 		wheel->Setup<T>(dev);
+		wheel->BuildAtlas(dev);
 		return std::move(wheel);
 	}
 
@@ -46,6 +50,8 @@ public:
 	void AddElement(std::unique_ptr<WheelElement>&& we) { wheelElements_.push_back(std::move(we)); Sort(); }
 	void Draw(IDirect3DDevice9* dev, Effect* fx, class UnitQuad* quad);
 	void OnFocusLost();
+	// Releases every wheel's instance buffer, which lives in D3DPOOL_DEFAULT and would make a device reset fail; the next draw recreates it
+	static void OnDeviceUnset();
 
 	bool drawOverUI() const { return showOverGameUIOption_.value(); }
 
@@ -54,11 +60,14 @@ public:
 
 protected:
 	void Sort();
+	void BuildAtlas(IDirect3DDevice9* dev);
 	WheelElement* GetCenterHoveredElement();
 	WheelElement* GetFavorite(int favoriteId);
-	std::vector<WheelElement*> GetActiveElements();
+	struct ActiveElements;
+	std::shared_ptr<const ActiveElements> UpdateActiveElements();
+	void DrawElements(IDirect3DDevice9* dev, Effect* fx, class UnitQuad* quad, const ActiveElements& active, const fVector4& baseSpriteDimensions, const std::vector<float>& hoveredFadeIns);
 	bool OnMouseMove();
-	InputResponse OnInputChange(bool changed, const std::set<uint>& keys, const std::list<EventKey>& changedKeys);
+	InputResponse OnInputChange(bool changed, const KeyCombo& keys, const EventKeys& changedKeys);
 	void ActivateWheel(bool isMountOverlayLocked);
 	void DeactivateWheel();
 
@@ -69,6 +78,18 @@ protected:
 
 	std::vector<std::unique_ptr<WheelElement>> wheelElements_;
 	bool isVisible_ = false;
+
+	struct ActiveElements
+	{
+		std::vector<WheelElement*> elements;
+		WheelLayout layout;
+		bool isWvW = false;
+	};
+
+	// Rebuilt by UpdateActiveElements on the render thread only when elements are reordered, shown, hidden or rebound,
+	// or the map type changes. Each rebuild is a new snapshot, so the input thread hovers over one without locking.
+	std::shared_ptr<const ActiveElements> activeElements_ = std::make_shared<const ActiveElements>();
+	std::atomic<bool> activeElementsDirty_ { true };
 	uint minElementSortingPriority_ = 0;
 	Keybind keybind_, centralKeybind_;
 
@@ -97,6 +118,12 @@ protected:
 	
 	IDirect3DTexture9* backgroundTexture_ = nullptr;
 	IDirect3DTexture9* inkTexture_ = nullptr;
+
+	// Filled every frame and drawn in one call per texture, or one call per element if the effect cannot instance
+	std::unique_ptr<InstancedQuad> instances_;
+	std::vector<QuadInstance> instanceData_;
+	std::vector<IDirect3DTexture9*> instanceTextures_;
+	static std::vector<Wheel*> liveWheels_;
 	
 	Input::MouseMoveCallback mouseMoveCallback_;
 	Input::InputChangeCallback inputChangeCallback_;
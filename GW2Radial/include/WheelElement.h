@@ -2,6 +2,7 @@
 #include <Main.h>
 #include <ImGuiExtensions.h>
 #include <SettingsMenu.h>
+#include <InstancedQuad.h>
 
 namespace GW2Radial
 {
@@ -14,7 +15,11 @@ public:
 
 	int DrawPriority(int extremumIndicator);
 
-	void Draw(int n, fVector4 spriteDimensions, size_t activeElementsCount, const mstime& currentTime, const WheelElement* elementHovered, const class Wheel* parent);
+	// spriteDimensions already place the element on the wheel
+	QuadInstance Instance(const fVector4& spriteDimensions, float hoverFadeIn);
+	IDirect3DTexture9* appearance() const { return appearance_; }
+	// Shows part of a texture shared with other elements instead of the element's own
+	void appearance(IDirect3DTexture9* texture, const fVector4& uvRect);
 
 	uint elementId() const { return elementId_; }
 	
@@ -46,6 +51,8 @@ protected:
 	uint elementId_;
 	Keybind keybind_;
 	IDirect3DTexture9* appearance_ = nullptr;
+	// Part of appearance_ holding this element's image
+	fVector4 uvRect_ = { 0.f, 0.f, 1.f, 1.f };
 	mstime currentHoverTime_ = 0;
 	mstime currentExitTime_ = 0;
 };
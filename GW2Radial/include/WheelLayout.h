@@ -0,0 +1,35 @@
+#pragma once
+
+#include <Main.h>
+#include <vector>
+
+namespace GW2Radial
+{
+
+// Geometry of a wheel showing a given number of elements: where each one is drawn and which sector the cursor is in.
+// It only depends on the element count, so the trigonometry happens once per change rather than every frame or mouse move.
+class WheelLayout
+{
+public:
+	// Where an element sits on the wheel, relative to the wheel's own sprite dimensions, and its size before hovering enlarges it
+	struct Placement
+	{
+		fVector2 location;
+		float diameter;
+	};
+
+	explicit WheelLayout(size_t count = 0);
+
+	size_t size() const { return placements_.size(); }
+	const Placement& operator[](size_t i) const { return placements_[i]; }
+
+	// Index of the element whose sector direction falls into
+	int HoveredSector(const fVector2& direction) const;
+
+protected:
+	// Sector i starts at boundary i and ends at boundary i + 1, clockwise from the top
+	std::vector<fVector2> sectorBoundaries_;
+	std::vector<Placement> placements_;
+};
+
+}
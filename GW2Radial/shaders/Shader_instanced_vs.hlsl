@@ -0,0 +1,8 @@
+#pragma warning(disable : 4717)
+#include "Sprite.hlsl"
+
+// Draws every wheel element at once: UV comes from the unit quad on stream 0, the rest from one QuadInstance per element on stream 1
+VS_SCREEN main(in float2 UV : TEXCOORD0, in float4 spriteDimensions : TEXCOORD1, in float4 uvRect : TEXCOORD2, in float4 color : TEXCOORD3, in float4 params : TEXCOORD4)
+{
+	return MakeSprite(UV, spriteDimensions, uvRect, color, params);
+}
\ No newline at end of file
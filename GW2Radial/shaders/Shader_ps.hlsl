@@ -10,6 +10,9 @@ struct PS_INPUT
 {
 	float4 pos : POSITION;
 	float2 UV: TEXCOORD0;
+	float4 UVRect : TEXCOORD1;
+	float4 Color : TEXCOORD2;
+	float4 Params : TEXCOORD3;
 };
 
 sampler2D texBgImageSampler : register ( s0 );
@@ -25,10 +28,6 @@ float g_fCenterScale : register ( c2 );
 // Total number of elements, cannot be larger than MAX_ELEMENT_COUNT
 float g_iElementCount : register ( c3 );
 float3 g_vInkSpot : register ( c4 );
-// Current element ID
-float g_iElementID : register (c5);
-// Color of the current element
-float4 g_vElementColor : register (c6);
 
 float techId : register (c7);
 
@@ -144,22 +143,28 @@ float4 BgImage_PS(PS_INPUT In)
 	return color * saturate(edge_mask * center_mask) * clamp(border_mask, 1.f, 2.f) * clamp(luma, 0.8f, 1.2f) * wheelFadeIn.xxxy;
 }
 
+// Samples the element's image, which may only be part of its texture, clamping to the image's edges
+float4 ElementImage(PS_INPUT In, float2 offset)
+{
+	return tex2D(texElementImageSampler, lerp(In.UVRect.xy, In.UVRect.zw, saturate(In.UV + offset)));
+}
+
 float4 MountImage_PS(PS_INPUT In, float imageIsMask)
 {
-	float hoverFadeIn = g_fHoverFadeIns_lookup(g_iElementID);
+	float hoverFadeIn = In.Params.x;
 
 	float mask = 1, shadow = 0;
 	float4 color = 1;
 	if(imageIsMask > 0)
 	{
-		mask = 1.f - tex2D(texElementImageSampler, In.UV).r;
-		shadow = 1.f - tex2D(texElementImageSampler, In.UV + 0.01f).r;
+		mask = 1.f - ElementImage(In, 0).r;
+		shadow = 1.f - ElementImage(In, 0.01f).r;
 
-		color = g_vElementColor;
+		color = In.Color;
 	}
 	else
 	{
-		color = tex2D(texElementImageSampler, In.UV);
+		color = ElementImage(In, 0);
 	}
 	
 	float3 g_vLumaDot = float3(0.2126, 0.7152, 0.0722);
@@ -173,10 +178,10 @@ float4 MountImage_PS(PS_INPUT In, float imageIsMask)
 		finalColor = lerp(fadedColor, color.rgb, hoverFadeIn);
 
 		float glowMask = 0;
-		glowMask += 1.f - tex2D(texElementImageSampler, In.UV + float2(0.01f, 0.01f)).r;
-		glowMask += 1.f - tex2D(texElementImageSampler, In.UV + float2(-0.01f, 0.01f)).r;
-		glowMask += 1.f - tex2D(texElementImageSampler, In.UV + float2(0.01f, -0.01f)).r;
-		glowMask += 1.f - tex2D(texElementImageSampler, In.UV + float2(-0.01f, -0.01f)).r;
+		glowMask += 1.f - ElementImage(In, float2(0.01f, 0.01f)).r;
+		glowMask += 1.f - ElementImage(In, float2(-0.01f, 0.01f)).r;
+		glowMask += 1.f - ElementImage(In, float2(0.01f, -0.01f)).r;
+		glowMask += 1.f - ElementImage(In, float2(-0.01f, -0.01f)).r;
 
 		glow = color.rgb * (glowMask / 4) * hoverFadeIn * 0.5f * (0.5f + 0.5f * snoise(In.UV * 3.18f + 0.15f * float2(cos(g_fAnimationTimer * 3), sin(g_fAnimationTimer * 2))));
 	}
@@ -0,0 +1,33 @@
+#ifndef SPRITE_HLSL
+#define SPRITE_HLSL
+
+struct VS_SCREEN
+{
+	float4 Position : POSITION;
+	float2 UV : TEXCOORD0;
+	// Min and max texture coordinates of the element's image
+	float4 UVRect : TEXCOORD1;
+	// Color of the element
+	float4 Color : TEXCOORD2;
+	// x: [0..1] ratio of fade in when hovering over the element
+	float4 Params : TEXCOORD3;
+};
+
+// Places a corner of the unit quad given sprite dimensions as ([0..1] position x, [0..1] position y, scaled size x, scaled size y)
+VS_SCREEN MakeSprite(float2 UV, float4 spriteDimensions, float4 uvRect, float4 color, float4 params)
+{
+	VS_SCREEN Out = (VS_SCREEN)0;
+
+	float2 dims = (UV * 2 - 1) * spriteDimensions.zw;
+
+	Out.UV = UV;
+	Out.Position = float4(dims + spriteDimensions.xy * 2 - 1, 0.5f, 1.f);
+	Out.Position.y *= -1;
+	Out.UVRect = uvRect;
+	Out.Color = color;
+	Out.Params = params;
+
+	return Out;
+}
+
+#endif
@@ -0,0 +1,169 @@
+#include <AtlasPacker.h>
+#include <algorithm>
+#include <cstring>
+
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include <imgui/stb_rect_pack.h>
+
+namespace GW2Radial
+{
+
+bool AtlasPacker::Pack(const std::vector<Image>& images, uint blockSize, uint maxLevels, uint maxBorder, uint maxDimension, bool powerOfTwo, Layout& layout)
+{
+	layout = Layout();
+	if (images.empty() || blockSize == 0 || maxLevels == 0)
+		return false;
+
+	// A cell must divide every image and still span whole blocks on the last level kept
+	const auto fitsCells = [&images](uint cell)
+	{
+		return std::all_of(images.begin(), images.end(), [cell](const Image& i) { return i.width > 0 && i.height > 0 && i.width % cell == 0 && i.height % cell == 0; });
+	};
+
+	uint levels = std::min(maxLevels, 16u);
+	while (levels > 1 && ((blockSize << (levels - 1)) > maxBorder || !fitsCells(blockSize << (levels - 1))))
+		levels--;
+	if (!fitsCells(blockSize))
+		return false;
+
+	const uint cell = blockSize << (levels - 1);
+	const uint maxCells = maxDimension / cell;
+
+	const auto roundUp = [powerOfTwo](uint cells)
+	{
+		if (!powerOfTwo)
+			return cells;
+		uint p = 1;
+		while (p < cells)
+			p <<= 1;
+		return p;
+	};
+
+	std::vector<stbrp_rect> rects(images.size());
+	uint widest = 0, tallest = 0;
+	for (size_t i = 0; i < images.size(); i++)
+	{
+		rects[i].id = int(i);
+		rects[i].w = stbrp_coord(images[i].width / cell + 2);
+		rects[i].h = stbrp_coord(images[i].height / cell + 2);
+		widest = std::max(widest, uint(rects[i].w));
+		tallest = std::max(tallest, uint(rects[i].h));
+	}
+
+	// Pack into strips of increasing width and keep the one leaving the smallest, then squarest, atlas;
+	// no strip can beat it once the width times the tallest image is already larger
+	std::vector<stbrp_node> nodes(std::max(1u, maxCells));
+	uint64_t bestArea = ~uint64_t(0);
+	uint bestSide = ~0u;
+	for (uint width = roundUp(widest); width <= maxCells && uint64_t(width) * tallest <= bestArea; width = powerOfTwo ? width * 2 : width + 1)
+	{
+		stbrp_context context;
+		stbrp_init_target(&context, int(width), int(maxCells), nodes.data(), int(nodes.size()));
+		if (!stbrp_pack_rects(&context, rects.data(), int(rects.size())))
+			continue;
+
+		uint height = 0;
+		for (const auto& r : rects)
+			height = std::max(height, uint(r.y + r.h));
+		height = roundUp(height);
+		const uint64_t area = uint64_t(width) * height;
+		const uint side = std::max(width, height);
+		if (height > maxCells || area > bestArea || (area == bestArea && side >= bestSide))
+			continue;
+
+		bestArea = area;
+		bestSide = side;
+		layout.width = width * cell;
+		layout.height = height * cell;
+		layout.levels = levels;
+		layout.cellSize = cell;
+		layout.positions.resize(images.size());
+		for (const auto& r : rects)
+			layout.positions[r.id] = { uint(r.x + 1) * cell, uint(r.y + 1) * cell };
+	}
+
+	return !layout.positions.empty();
+}
+
+// Replaces every index of a 4x4 block, stored bitsPerTexel apiece from the lowest bit up in row major order, with the
+// one in the given column and row; a negative column or row keeps each texel's own
+static void RepeatIndices(uint8_t* bits, uint bitsPerTexel, int column, int row)
+{
+	uint64_t indices = 0;
+	const uint bytes = bitsPerTexel * 16 / 8;
+	memcpy(&indices, bits, bytes);
+
+	const uint64_t mask = (uint64_t(1) << bitsPerTexel) - 1;
+	uint64_t repeated = 0;
+	for (uint y = 0; y < 4; y++)
+	{
+		for (uint x = 0; x < 4; x++)
+		{
+			const uint from = (row < 0 ? y : uint(row)) * 4 + (column < 0 ? x : uint(column));
+			repeated |= (indices >> (from * bitsPerTexel) & mask) << ((y * 4 + x) * bitsPerTexel);
+		}
+	}
+
+	memcpy(bits, &repeated, bytes);
+}
+
+// Turns a copy of an edge block into one of its border: the endpoints stay, only which of them each texel picks changes
+static void RepeatEdge(AtlasPacker::Encoding encoding, uint8_t* block, int column, int row)
+{
+	switch (encoding)
+	{
+	case AtlasPacker::Encoding::DXT1:
+		RepeatIndices(block + 4, 2, column, row);
+		break;
+	case AtlasPacker::Encoding::DXT3:
+		RepeatIndices(block, 4, column, row);
+		RepeatIndices(block + 12, 2, column, row);
+		break;
+	case AtlasPacker::Encoding::DXT5:
+		RepeatIndices(block + 2, 3, column, row);
+		RepeatIndices(block + 12, 2, column, row);
+		break;
+	default:
+		break;
+	}
+}
+
+void AtlasPacker::CopyLevel(const Layout& layout, const Image& image, const Position& position, uint level, const Format& format,
+                            const uint8_t* src, uint srcPitch, uint8_t* dst, uint dstPitch)
+{
+	const int blockSize = int(format.blockSize);
+	const int bytesPerBlock = int(format.bytesPerBlock);
+	const int border = int(layout.cellSize >> level) / blockSize;
+	const int columns = int(image.width >> level) / blockSize;
+	const int rows = int(image.height >> level) / blockSize;
+	const int left = int(position.x >> level) / blockSize;
+	const int top = int(position.y >> level) / blockSize;
+
+	for (int y = -border; y < rows + border; y++)
+	{
+		// Above and below the image, the whole block takes the texels of its edge row
+		const int edgeRow = y < 0 ? 0 : y >= rows ? blockSize - 1 : -1;
+		const uint8_t* from = src + std::clamp(y, 0, rows - 1) * srcPitch;
+		uint8_t* to = dst + (top + y) * dstPitch + left * bytesPerBlock;
+
+		memcpy(to, from, columns * bytesPerBlock);
+		if (edgeRow >= 0)
+		{
+			for (int x = 0; x < columns; x++)
+				RepeatEdge(format.encoding, to + x * bytesPerBlock, -1, edgeRow);
+		}
+
+		for (int x = 1; x <= border; x++)
+		{
+			uint8_t* leftBlock = to - x * bytesPerBlock;
+			uint8_t* rightBlock = to + (columns - 1 + x) * bytesPerBlock;
+			memcpy(leftBlock, from, bytesPerBlock);
+			memcpy(rightBlock, from + (columns - 1) * bytesPerBlock, bytesPerBlock);
+			RepeatEdge(format.encoding, leftBlock, 0, edgeRow);
+			RepeatEdge(format.encoding, rightBlock, blockSize - 1, edgeRow);
+		}
+	}
+}
+
+}
@@ -0,0 +1,73 @@
+#include <Base64.h>
+#include <array>
+
+namespace GW2Radial
+{
+
+constexpr uint8_t InvalidBase64 = 0xFF;
+
+constexpr std::array<uint8_t, 256> MakeBase64Table()
+{
+	std::array<uint8_t, 256> table { };
+	for (auto& t : table)
+		t = InvalidBase64;
+
+	constexpr char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	for (uint8_t i = 0; i < 64; i++)
+		table[uint8_t(alphabet[i])] = i;
+
+	return table;
+}
+
+constexpr auto Base64Table = MakeBase64Table();
+
+inline uint32_t Base64Value(wchar_t c)
+{
+	return uint32_t(c) < Base64Table.size() ? Base64Table[uint32_t(c)] : InvalidBase64;
+}
+
+size_t Base64Decode(std::wstring_view in, uint8_t* out, size_t outSize)
+{
+	const wchar_t* src = in.data();
+	const wchar_t* const srcEnd = src + in.size();
+	uint8_t* dst = out;
+	uint8_t* const dstEnd = out + outSize;
+
+	// Full groups: four characters into three bytes, bailing out to the tail on anything unusual
+	while (srcEnd - src >= 4 && dstEnd - dst >= 3)
+	{
+		const uint32_t a = Base64Value(src[0]), b = Base64Value(src[1]), c = Base64Value(src[2]), d = Base64Value(src[3]);
+		if (((a | b | c | d) & 0xC0) != 0)
+			break;
+
+		const uint32_t bits = (a << 18) | (b << 12) | (c << 6) | d;
+		dst[0] = uint8_t(bits >> 16);
+		dst[1] = uint8_t(bits >> 8);
+		dst[2] = uint8_t(bits);
+
+		src += 4;
+		dst += 3;
+	}
+
+	// Tail: at most three valid characters remain before padding, an invalid character or the end
+	uint32_t bits = 0;
+	int count = 0;
+	for (; src != srcEnd && count < 4; ++src, ++count)
+	{
+		const auto v = Base64Value(*src);
+		if (v == InvalidBase64)
+			break;
+		bits = (bits << 6) | v;
+	}
+
+	if (count > 1)
+	{
+		bits <<= 6 * (4 - count);
+		for (int i = 0; i < count - 1 && dst != dstEnd; i++)
+			*dst++ = uint8_t(bits >> (16 - 8 * i));
+	}
+
+	return size_t(dst - out);
+}
+
+}
@@ -0,0 +1,99 @@
+#include <ChatDedup.h>
+#include <algorithm>
+
+namespace GW2Radial
+{
+
+ChatDedup::ChatDedup(const Limits& limits)
+	: limits_(limits)
+{
+	limits_.maxLines = std::max<size_t>(1, limits_.maxLines);
+	fifo_.resize(limits_.maxLines);
+
+	size_t tableSize = 1;
+	while (tableSize < limits_.maxLines * 2)
+		tableSize <<= 1;
+	table_.assign(tableSize, 0);
+	mask_ = tableSize - 1;
+}
+
+bool ChatDedup::Admit(std::wstring_view raw, mstime time)
+{
+	auto hash = XXH64(raw.data(), raw.size() * sizeof(wchar_t), 0);
+	if (hash == 0)
+		hash = 1;
+
+	Expire(time);
+
+	const auto slot = Find(hash);
+	if (table_[slot] == hash)
+	{
+		suppressed_++;
+		return false;
+	}
+
+	if (count_ == fifo_.size())
+	{
+		EraseFromTable(fifo_[first_].hash);
+		first_ = (first_ + 1) % fifo_.size();
+		count_--;
+	}
+
+	// Erasing may have shifted entries around, so look the slot up again
+	table_[Find(hash)] = hash;
+	fifo_[(first_ + count_) % fifo_.size()] = { hash, time };
+	count_++;
+	admitted_++;
+
+	return true;
+}
+
+void ChatDedup::Clear()
+{
+	std::fill(table_.begin(), table_.end(), 0);
+	first_ = count_ = 0;
+}
+
+size_t ChatDedup::Find(XXH64_hash_t hash) const
+{
+	size_t i = size_t(hash) & mask_;
+	while (table_[i] != 0 && table_[i] != hash)
+		i = (i + 1) & mask_;
+	return i;
+}
+
+void ChatDedup::Expire(mstime time)
+{
+	if (limits_.window == 0)
+		return;
+
+	while (count_ > 0 && time - fifo_[first_].time >= limits_.window)
+	{
+		EraseFromTable(fifo_[first_].hash);
+		first_ = (first_ + 1) % fifo_.size();
+		count_--;
+	}
+}
+
+void ChatDedup::EraseFromTable(XXH64_hash_t hash)
+{
+	size_t hole = Find(hash);
+	if (table_[hole] != hash)
+		return;
+
+	// Backward shift deletion: pull later members of the probe run into the hole
+	// so lookups never need tombstones
+	for (size_t i = (hole + 1) & mask_; table_[i] != 0; i = (i + 1) & mask_)
+	{
+		const size_t home = size_t(table_[i]) & mask_;
+		if (((i - home) & mask_) >= ((i - hole) & mask_))
+		{
+			table_[hole] = table_[i];
+			hole = i;
+		}
+	}
+
+	table_[hole] = 0;
+}
+
+}
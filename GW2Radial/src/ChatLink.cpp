@@ -0,0 +1,214 @@
+#include <ChatLink.h>
+#include <cstdio>
+
+namespace GW2Radial
+{
+
+constexpr size_t NoLayout = ~size_t(0);
+
+constexpr size_t FixedPayloadSize(ChatLinkType type)
+{
+	switch (type)
+	{
+	case ChatLinkType::COIN:
+		return ChatLinkLayout<ChatLinkType::COIN>::size;
+	case ChatLinkType::ITEM:
+		return ChatLinkLayout<ChatLinkType::ITEM>::size;
+	case ChatLinkType::NPC_TEXT:
+		return ChatLinkLayout<ChatLinkType::NPC_TEXT>::size;
+	case ChatLinkType::MAP:
+		return ChatLinkLayout<ChatLinkType::MAP>::size;
+	case ChatLinkType::SKILL:
+		return ChatLinkLayout<ChatLinkType::SKILL>::size;
+	case ChatLinkType::TRAIT:
+		return ChatLinkLayout<ChatLinkType::TRAIT>::size;
+	case ChatLinkType::PLAYER:
+		return ChatLinkLayout<ChatLinkType::PLAYER>::size;
+	case ChatLinkType::RECIPE:
+		return ChatLinkLayout<ChatLinkType::RECIPE>::size;
+	case ChatLinkType::WARDROBE:
+		return ChatLinkLayout<ChatLinkType::WARDROBE>::size;
+	case ChatLinkType::OUTFIT:
+		return ChatLinkLayout<ChatLinkType::OUTFIT>::size;
+	case ChatLinkType::WVW_OBJECTIVE:
+		return ChatLinkLayout<ChatLinkType::WVW_OBJECTIVE>::size;
+	default:
+		return NoLayout;
+	}
+}
+
+constexpr size_t ItemOptionalIdCount(uint8_t flags)
+{
+	using L = ChatLinkLayout<ChatLinkType::ITEM>;
+	return ((flags & L::skinFlag) ? 1 : 0) + ((flags & L::upgrade1Flag) ? 1 : 0) + ((flags & L::upgrade2Flag) ? 1 : 0);
+}
+
+ChatLink::ChatLink(const uint8_t* data, size_t size)
+{
+	if (size < 1)
+		return;
+
+	const auto type = ChatLinkType(data[0]);
+	const auto fixedSize = FixedPayloadSize(type);
+	if (fixedSize == NoLayout || size - 1 < fixedSize)
+		return;
+
+	const uint8_t* payload = data + 1;
+	if (type == ChatLinkType::ITEM && size - 1 < fixedSize + 4 * ItemOptionalIdCount(payload[ChatLinkLayout<ChatLinkType::ITEM>::flagsOffset]))
+		return;
+
+	type_ = type;
+	payload_ = payload;
+	payloadSize_ = size - 1;
+}
+
+uint32_t ChatLink::ItemOptionalId(uint8_t flag) const
+{
+	using L = ChatLinkLayout<ChatLinkType::ITEM>;
+
+	const uint8_t flags = payload_[L::flagsOffset];
+	if (!(flags & flag))
+		return 0;
+
+	// Optional ids are stored in flag order, highest bit first
+	size_t offset = L::size;
+	for (uint8_t f = L::skinFlag; f > flag; f >>= 1)
+		if (flags & f)
+			offset += 4;
+
+	return ReadU32(offset);
+}
+
+size_t ChatLink::playerName(wchar_t* out, size_t outChars) const
+{
+	if (outChars == 0)
+		return 0;
+
+	size_t n = 0;
+	if (type_ == ChatLinkType::PLAYER)
+	{
+		for (size_t i = ChatLinkLayout<ChatLinkType::PLAYER>::nameOffset; i + 1 < payloadSize_ && n + 1 < outChars; i += 2)
+		{
+			const auto c = wchar_t(payload_[i] | payload_[i + 1] << 8);
+			if (c == L'\0')
+				break;
+			out[n++] = c;
+		}
+	}
+
+	out[n] = L'\0';
+	return n;
+}
+
+// Link payloads carry UTF-16LE, which is converted directly so this stays independent from the Windows APIs
+static void AppendUtf16AsUtf8(std::string& out, const uint8_t* data, size_t size)
+{
+	for (size_t i = 0; i + 1 < size; i += 2)
+	{
+		uint32_t c = data[i] | data[i + 1] << 8;
+		if (c == 0)
+			break;
+
+		if (c >= 0xD800 && c < 0xDC00 && i + 3 < size)
+		{
+			const uint32_t low = data[i + 2] | data[i + 3] << 8;
+			if (low >= 0xDC00 && low < 0xE000)
+			{
+				c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+				i += 2;
+			}
+		}
+
+		if (c < 0x80)
+			out += char(c);
+		else if (c < 0x800)
+		{
+			out += char(0xC0 | c >> 6);
+			out += char(0x80 | (c & 0x3F));
+		}
+		else if (c < 0x10000)
+		{
+			out += char(0xE0 | c >> 12);
+			out += char(0x80 | (c >> 6 & 0x3F));
+			out += char(0x80 | (c & 0x3F));
+		}
+		else
+		{
+			out += char(0xF0 | c >> 18);
+			out += char(0x80 | (c >> 12 & 0x3F));
+			out += char(0x80 | (c >> 6 & 0x3F));
+			out += char(0x80 | (c & 0x3F));
+		}
+	}
+}
+
+void ChatLink::Describe(std::string& out) const
+{
+	char buf[64];
+	const auto idLink = [&](const char* label) { snprintf(buf, sizeof(buf), "[%s %u]", label, id()); };
+
+	switch (type_)
+	{
+	case ChatLinkType::COIN:
+	{
+		const auto c = coins();
+		if (c >= 10000)
+			snprintf(buf, sizeof(buf), "[%ug %us %uc]", c / 10000, c / 100 % 100, c % 100);
+		else if (c >= 100)
+			snprintf(buf, sizeof(buf), "[%us %uc]", c / 100, c % 100);
+		else
+			snprintf(buf, sizeof(buf), "[%uc]", c);
+		break;
+	}
+	case ChatLinkType::ITEM:
+		if (itemCount() > 1)
+			snprintf(buf, sizeof(buf), "[%u x Item %u]", uint32_t(itemCount()), itemId());
+		else
+			snprintf(buf, sizeof(buf), "[Item %u]", itemId());
+		break;
+	case ChatLinkType::NPC_TEXT:
+		idLink("Text");
+		break;
+	case ChatLinkType::MAP:
+		idLink("Map");
+		break;
+	case ChatLinkType::SKILL:
+		idLink("Skill");
+		break;
+	case ChatLinkType::TRAIT:
+		idLink("Trait");
+		break;
+	case ChatLinkType::RECIPE:
+		idLink("Recipe");
+		break;
+	case ChatLinkType::WARDROBE:
+		idLink("Skin");
+		break;
+	case ChatLinkType::OUTFIT:
+		idLink("Outfit");
+		break;
+	case ChatLinkType::WVW_OBJECTIVE:
+		snprintf(buf, sizeof(buf), "[Objective %u-%u]", wvwMapId(), id());
+		break;
+	case ChatLinkType::PLAYER:
+	{
+		constexpr auto nameOffset = ChatLinkLayout<ChatLinkType::PLAYER>::nameOffset;
+		out += '[';
+		AppendUtf16AsUtf8(out, payload_ + nameOffset, payloadSize_ - nameOffset);
+		out += ']';
+		return;
+	}
+	default:
+		return;
+	}
+
+	out += buf;
+}
+
+ChatLink DecodeChatLink(std::wstring_view encoded, ChatLinkBuffer& buffer)
+{
+	buffer.size = Base64Decode(encoded.substr(0, ChatLinkBuffer::MaxEncodedLength), buffer.bytes.data(), buffer.bytes.size());
+	return ChatLink(buffer.bytes.data(), buffer.size);
+}
+
+}
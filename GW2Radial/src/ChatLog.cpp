@@ -0,0 +1,92 @@
+#include <ChatLog.h>
+#include <algorithm>
+
+namespace GW2Radial
+{
+
+ChatLog::ChatLog(const Limits& limits)
+{
+	this->limits(limits);
+}
+
+void ChatLog::limits(const Limits& limits)
+{
+	const size_t lines = std::max<size_t>(1, limits.maxLines);
+
+	if (lines + 1 != slots_.size())
+	{
+		// Keep the newest messages which fit, in order, at the start of the new ring
+		std::vector<ChatMessage> slots(lines + 1);
+		const size_t kept = std::min(count_, lines);
+		bytes_ = 0;
+		for (size_t i = 0; i < kept; i++)
+		{
+			auto& m = slots_[(first_ + count_ - kept + i) % slots_.size()];
+			bytes_ += m.text().size();
+			slots[i] = std::move(m);
+		}
+
+		evicted_ += count_ - kept;
+		slots_ = std::move(slots);
+		first_ = 0;
+		count_ = kept;
+	}
+
+	limits_ = limits;
+	limits_.maxLines = lines;
+
+	while (count_ > 0 && bytes_ > limits_.maxBytes)
+		EvictOldest();
+}
+
+bool ChatLog::Append(std::wstring_view raw, mstime time)
+{
+	// The ring keeps one spare slot, so the next slot is never a retained message
+	auto& slot = slots_[(first_ + count_) % slots_.size()];
+	if (!ParseChatMessage(raw, slot))
+		return false;
+	slot.time_ = time;
+
+	// Too large on its own, so it is never retained and must not push anything else out either
+	const size_t size = slot.text().size();
+	if (size > limits_.maxBytes)
+	{
+		slot.Recycle();
+		evicted_++;
+		return true;
+	}
+
+	if (count_ == limits_.maxLines)
+		EvictOldest();
+	while (count_ > 0 && bytes_ + size > limits_.maxBytes)
+		EvictOldest();
+
+	slot.serial_ = nextSerial_++;
+	bytes_ += size;
+	count_++;
+
+	return true;
+}
+
+void ChatLog::Prune(mstime now)
+{
+	if (limits_.maxAge == 0)
+		return;
+
+	// Messages may carry a later time than now, since producers stamp them on their own threads
+	while (count_ > 0 && (*this)[0].time() + limits_.maxAge < now)
+		EvictOldest();
+}
+
+void ChatLog::EvictOldest()
+{
+	auto& slot = slots_[first_];
+	bytes_ -= slot.text().size();
+	slot.Recycle();
+
+	first_ = (first_ + 1) % slots_.size();
+	count_--;
+	evicted_++;
+}
+
+}
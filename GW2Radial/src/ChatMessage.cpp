@@ -0,0 +1,93 @@
+#include <ChatMessage.h>
+#include <ChatLink.h>
+
+namespace GW2Radial
+{
+
+bool ScanChatQuote(std::wstring_view raw, std::wstring_view& link, std::wstring_view& body)
+{
+	constexpr std::wstring_view linkOpen = L"quote>[&";
+	constexpr std::wstring_view linkClose = L"]: ";
+
+	// Nothing in the grammar may span a line terminator, so only the last line can match
+	const auto lastBreak = raw.find_last_of(L"\n\r\u2028\u2029");
+	const auto line = lastBreak == std::wstring_view::npos ? raw : raw.substr(lastBreak + 1);
+
+	// The body starts after the last separator, and the link after the last opening which precedes it
+	const auto closePos = line.rfind(linkClose);
+	if (closePos == std::wstring_view::npos || closePos < linkOpen.size())
+		return false;
+
+	const auto openPos = line.rfind(linkOpen, closePos - linkOpen.size());
+	if (openPos == std::wstring_view::npos)
+		return false;
+
+	link = line.substr(openPos + linkOpen.size(), closePos - openPos - linkOpen.size());
+	body = line.substr(closePos + linkClose.size());
+
+	return true;
+}
+
+// Converts the body to UTF-8, replacing any valid [&...] links with a readable description
+static void AppendBody(std::string& out, std::wstring_view body)
+{
+	constexpr std::wstring_view linkOpen = L"[&";
+	constexpr std::wstring_view base64Chars = L"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/=";
+
+	ChatLinkBuffer buffer;
+	size_t plainStart = 0;
+	for (auto pos = body.find(linkOpen); pos != std::wstring_view::npos; pos = body.find(linkOpen, pos))
+	{
+		const auto end = body.find(L']', pos + linkOpen.size());
+		if (end == std::wstring_view::npos)
+			break;
+
+		const auto encoded = body.substr(pos + linkOpen.size(), end - pos - linkOpen.size());
+		const auto link = encoded.find_first_not_of(base64Chars) == std::wstring_view::npos ? DecodeChatLink(encoded, buffer) : ChatLink();
+		if (!link.valid())
+		{
+			pos += linkOpen.size();
+			continue;
+		}
+
+		if (pos > plainStart)
+			out += utf8_encode(std::wstring(body.substr(plainStart, pos - plainStart)));
+		link.Describe(out);
+
+		pos = plainStart = end + 1;
+	}
+
+	if (plainStart < body.size())
+		out += utf8_encode(std::wstring(body.substr(plainStart)));
+}
+
+bool ParseChatMessage(std::wstring_view raw, ChatMessage& out)
+{
+	std::wstring_view b64name, text;
+	if (!ScanChatQuote(raw, b64name, text))
+		return false;
+
+	ChatLinkBuffer buffer;
+	const auto senderLink = DecodeChatLink(b64name, buffer);
+	if (senderLink.type() != ChatLinkType::PLAYER)
+		return false;
+
+	wchar_t username[255];
+	senderLink.playerName(username, std::size(username));
+
+	const std::wstring sender(username);
+	if (sender.empty() || text.empty())
+		return false;
+
+	// Append rather than assign so a recycled record keeps its buffer
+	out.text_.clear();
+	out.text_ += utf8_encode(sender);
+	out.senderLength_ = out.text_.size();
+	out.text_ += ": ";
+	out.bodyOffset_ = out.text_.size();
+	AppendBody(out.text_, text);
+
+	return true;
+}
+
+}
@@ -0,0 +1,124 @@
+#include <ChatView.h>
+#include <imgui/imgui_internal.h>
+
+namespace GW2Radial
+{
+
+void ChatView::Draw(const ChatLog& log)
+{
+	const ImFont* font = ImGui::GetFont();
+	const float fontSize = ImGui::GetFontSize();
+	const ImU32 color = ImGui::GetColorU32(ImGuiCol_Text);
+	if (font != font_ || fontSize != fontSize_ || color != color_)
+	{
+		Invalidate();
+		font_ = font;
+		fontSize_ = fontSize;
+		color_ = color;
+	}
+
+	if (lines_.size() != log.capacity())
+	{
+		lines_.clear();
+		lines_.resize(log.capacity());
+	}
+
+	if (!scratch_)
+		scratch_ = std::make_unique<ImDrawList>(ImGui::GetDrawListSharedData());
+
+	// Lines are never wrapped, so they all have the same height
+	ImGuiListClipper clipper(int(log.size()), ImGui::GetTextLineHeightWithSpacing());
+	while (clipper.Step())
+	{
+		for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
+			DrawLine(CachedLine(log[i]));
+	}
+}
+
+void ChatView::Invalidate()
+{
+	// Vertex buffers are kept for the next layout
+	for (auto& line : lines_)
+		line.serial = 0;
+}
+
+const ChatView::Line& ChatView::CachedLine(const ChatMessage& message)
+{
+	auto& line = lines_[message.serial() % lines_.size()];
+	if (line.serial == message.serial())
+		return line;
+
+	cacheMisses_++;
+
+	const char* begin = message.text().c_str();
+	const char* end = begin + message.text().size();
+
+	// Lay the line out at the origin without any clipping, culling happens when it is emitted
+	scratch_->Clear();
+	scratch_->PushClipRectFullScreen();
+	font_->RenderText(scratch_.get(), fontSize_, ImVec2(0.f, 0.f), color_, ImVec4(-FLT_MAX, -FLT_MAX, FLT_MAX, FLT_MAX), begin, end, 0.f, false);
+
+	line.vertices.assign(scratch_->VtxBuffer.begin(), scratch_->VtxBuffer.end());
+	line.width = ImGui::CalcTextSize(begin, end).x;
+	line.serial = message.serial();
+
+	return line;
+}
+
+void ChatView::DrawLine(const Line& line)
+{
+	ImGuiWindow* window = ImGui::GetCurrentWindow();
+
+	// Same item layout as ImGui::TextUnformatted
+	const ImVec2 pos(window->DC.CursorPos.x, window->DC.CursorPos.y + window->DC.CurrentLineTextBaseOffset);
+	const ImVec2 size(line.width, fontSize_);
+	ImGui::ItemSize(size);
+	if (!ImGui::ItemAdd(ImRect(pos.x, pos.y, pos.x + size.x, pos.y + size.y), 0))
+		return;
+
+	if (line.vertices.empty() || (color_ & IM_COL32_A_MASK) == 0)
+		return;
+
+	ImDrawList* drawList = window->DrawList;
+	IM_ASSERT(font_->ContainerAtlas->TexID == drawList->_TextureIdStack.back());
+
+	// ImFont::RenderText snaps the text origin to whole pixels
+	const ImVec2 origin(float(int(pos.x)), float(int(pos.y)));
+
+	// Cull glyphs outside the clip rect horizontally like RenderText does, relying on the quads being sorted by x
+	const ImVec4& clip = drawList->_ClipRectStack.back();
+	const ImDrawVert* first = line.vertices.data();
+	const ImDrawVert* last = first + line.vertices.size();
+	while (first != last && first[1].pos.x + origin.x < clip.x)
+		first += 4;
+	while (last != first && last[-4].pos.x + origin.x > clip.z)
+		last -= 4;
+
+	const int vtxCount = int(last - first);
+	if (vtxCount == 0)
+		return;
+
+	drawList->PrimReserve(vtxCount / 4 * 6, vtxCount);
+
+	ImDrawVert* vtx = drawList->_VtxWritePtr;
+	memcpy(vtx, first, vtxCount * sizeof(ImDrawVert));
+	for (int i = 0; i < vtxCount; i++)
+	{
+		vtx[i].pos.x += origin.x;
+		vtx[i].pos.y += origin.y;
+	}
+
+	ImDrawIdx* idx = drawList->_IdxWritePtr;
+	unsigned int base = drawList->_VtxCurrentIdx;
+	for (int i = 0; i < vtxCount; i += 4, idx += 6, base += 4)
+	{
+		idx[0] = ImDrawIdx(base); idx[1] = ImDrawIdx(base + 1); idx[2] = ImDrawIdx(base + 2);
+		idx[3] = ImDrawIdx(base); idx[4] = ImDrawIdx(base + 2); idx[5] = ImDrawIdx(base + 3);
+	}
+
+	drawList->_VtxWritePtr += vtxCount;
+	drawList->_IdxWritePtr = idx;
+	drawList->_VtxCurrentIdx = base;
+}
+
+}
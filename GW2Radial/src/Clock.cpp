@@ -0,0 +1,42 @@
+#include <Clock.h>
+
+namespace GW2Radial
+{
+
+std::atomic<int64_t> Clock::frameMicroseconds_ { 0 };
+thread_local const ClockSource* Clock::source_ = nullptr;
+
+static int64_t PerformanceFrequency()
+{
+	// Fixed at boot, so it only needs to be queried once
+	static const int64_t frequency = QueryCounterFrequency();
+	return frequency;
+}
+
+int64_t Clock::microseconds()
+{
+	// No source installed is by far the common case, and skips the virtual calls
+	if (const auto* s = source_)
+		return Convert(s->ticks(), s->ticksPerSecond(), 1000000);
+	return Convert(QueryCounter(), PerformanceFrequency(), 1000000);
+}
+
+class PerformanceCounter : public ClockSource
+{
+public:
+	int64_t ticks() const override { return QueryCounter(); }
+	int64_t ticksPerSecond() const override { return PerformanceFrequency(); }
+};
+
+const ClockSource& Clock::system()
+{
+	static const PerformanceCounter counter;
+	return counter;
+}
+
+const ClockSource& Clock::source()
+{
+	return source_ ? *source_ : system();
+}
+
+}
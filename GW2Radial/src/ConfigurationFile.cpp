@@ -1,6 +1,7 @@
 #include <ConfigurationFile.h>
 #include <Shlobj.h>
 #include <Utility.h>
+#include <Profiler.h>
 #include <tchar.h>
 #include <sstream>
 #include "../include/ImGuiPopup.h"
@@ -58,6 +59,8 @@ void ConfigurationFile::Reload()
 
 void ConfigurationFile::Save()
 {
+	PROFILE_SCOPE("ConfigurationFile::Save");
+
 	const auto r = ini_.SaveFile(location_.c_str());
 
 	if (r < 0)
@@ -146,6 +149,8 @@ void ConfigurationFile::SaveImGuiSettings(const std::wstring & location)
 	if(!imio.WantSaveIniSettings)
 		return;
 
+	PROFILE_SCOPE("ConfigurationFile::SaveImGuiSettings");
+
 	FILE *fp = nullptr;
 	if(_wfopen_s(&fp, location.c_str(), L"wt, ccs=UTF-8") != 0)
 		return;
@@ -19,11 +19,12 @@
 #include <MiscTab.h>
 #include <MumbleLink.h>
 #include <Effect_dx12.h>
+#include <Profiler.h>
+#include <Clock.h>
+#include <InputRecorder.h>
+#include <Keybind.h>
 #include <iostream>
 #include <string>
-#include <regex>
-
-std::wstring LastString;
 
 namespace GW2Radial
 {
@@ -60,162 +61,44 @@ Core::~Core()
 	}
 }
 
-std::string WstrToUtf8Str(const std::wstring& wstr)
+void Core::DrawTextDatas()
 {
-	std::string retStr = "err";
-	if (!wstr.empty())
-	{
-		int sizeRequired = WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), -1, NULL, 0, NULL, NULL);
-
-		if (sizeRequired > 0)
-		{
-			std::vector<char> utf8String(sizeRequired);
-			int bytesConverted = WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(),
-				-1, &utf8String[0], utf8String.size(), NULL,
-				NULL);
-			if (bytesConverted != 0)
-			{
-				retStr = &utf8String[0];
-			}
-			else
-			{
-				
-			}
-		}
-	}
-	return retStr;
-}
+	PROFILE_SCOPE("Core::DrawTextDatas");
 
-static const std::string base64_chars =
-"ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-"abcdefghijklmnopqrstuvwxyz"
-"0123456789+/";
+	if (!chatLog_)
+		return;
 
-static inline bool is_base64(unsigned char c) {
-	return (isalnum(c) || (c == '+') || (c == '/'));
-}
-
-std::string base64_decode(std::string const& encoded_string) {
-	int in_len = encoded_string.size();
-	int i = 0;
-	int j = 0;
-	int in_ = 0;
-	unsigned char char_array_4[4], char_array_3[3];
-	std::string ret;
-
-	while (in_len-- && (encoded_string[in_] != '=') && is_base64(encoded_string[in_])) {
-		char_array_4[i++] = encoded_string[in_]; in_++;
-		if (i == 4) {
-			for (i = 0; i < 4; i++)
-				char_array_4[i] = base64_chars.find(char_array_4[i]);
-
-			char_array_3[0] = (char_array_4[0] << 2) + ((char_array_4[1] & 0x30) >> 4);
-			char_array_3[1] = ((char_array_4[1] & 0xf) << 4) + ((char_array_4[2] & 0x3c) >> 2);
-			char_array_3[2] = ((char_array_4[2] & 0x3) << 6) + char_array_4[3];
-
-			for (i = 0; (i < 3); i++)
-				ret += char_array_3[i];
-			i = 0;
-		}
-	}
-
-	if (i) {
-		for (j = 0; j < i; j++)
-			char_array_4[j] = base64_chars.find(char_array_4[j]);
-
-		char_array_3[0] = (char_array_4[0] << 2) + ((char_array_4[1] & 0x30) >> 4);
-		char_array_3[1] = ((char_array_4[1] & 0xf) << 4) + ((char_array_4[2] & 0x3c) >> 2);
-
-		for (j = 0; (j < i - 1); j++) ret += char_array_3[j];
-	}
+	chatQueue_.Drain([this](const ChatQueue::Slot& slot) { IngestTextData(std::wstring(slot.text, slot.length), slot.time); });
+	chatLog_->Prune(Clock::frameMilliseconds());
 
-	return ret;
+	ImGui::Begin("ru chat");
+	chatView_.Draw(*chatLog_);
+	ImGui::End();
 }
 
-std::wstring FilterShit(const std::wstring base)
+#ifdef GW2RADIAL_INPUT_RECORDER
+void Core::DrawInputRecorder()
 {
-	//const std::wstring base(L"<quote>[&CGFMngACJRHqgbaVEDwNZJJNAGkAeQB1AGsAaQBuAHkAYQAAAA==]:   2");
-	//OutputDebugString(TEXT("FilterShit touch"));
-	std::wregex rgx(L".*quote>\\[&(.*)\\]: (.*)$");
-	std::wsmatch match;
-	std::wstring text;
-	std::wstring b64name;
-	if (std::regex_search(base.begin(), base.end(), match, rgx)) {
-		b64name = match[1];
-		text = match[2];
-	}
-	std::string decode = base64_decode(std::string(b64name.begin(), b64name.end()));
-	wchar_t username[255];
-	memset(username, 0, 255);
-	if (decode.length()>17)
-		memcpy(username, decode.c_str() + 17, decode.length() - 17);
-
-	if ((std::wstring(username).length()) == 0) {
-		return std::wstring(L"NONE");
-	}
-	if ((std::wstring(text).length()) == 0) {
-		return std::wstring(L"NONE");
-	}
-	return std::wstring(username) + L": " + text;
-}
-
-void Core::DrawTextDatas()
-{
-	int cnt = 0;
-
-	EnterCriticalSection(&cs);
-
-	char buf[2048];
-
+	// The chat window is the only one always shown, so the recorder folds into the bottom of it
 	ImGui::Begin("ru chat");
-
-	{
-		auto tmp = textDataMap;
-
-		while (!tmp.empty())
-		{
-			wchar_t* txt = tmp.front();
-			if (LastString != std::wstring(txt)) {
-				std::wstring txt2 = FilterShit(std::wstring(txt));
-				
-				if (txt2 != std::wstring(L"NONE"))
-				{
-					std::string str = WstrToUtf8Str(txt2);	
-
-					ImGui::Text("%s", str.c_str());
-
-					LastString = std::wstring(txt);
-				}
-			}
-				
-			tmp.pop();
-			++cnt;
-
-		}
-	}
-
+	if (ImGui::CollapsingHeader("Input recording"))
+		InputRecorder::i()->DrawMenu();
 	ImGui::End();
+}
+#endif
 
-	if (cnt > 10)
-	{
-		if ((GetTickCount() - lastRemTime) > 1000)
-		{
-			lastRemTime = GetTickCount();
-			free(textDataMap.front());
-			textDataMap.pop();
-		}
-	}
+void Core::IngestTextData(const std::wstring& raw, mstime time)
+{
+	// Repeated lines are dropped before they are parsed or stored
+	if (!chatDedup_->Admit(raw, time))
+		return;
 
-	LeaveCriticalSection(&cs);
+	chatLog_->Append(raw, time);
 }
 
 void Core::InsertTextData(wchar_t * val)
 {
-	EnterCriticalSection(&cs);
-
-	textDataMap.push(_wcsdup(val));
-
-	LeaveCriticalSection(&cs);
+	chatQueue_.Push(val, TimeInMilliseconds());
 }
 
 void Core::InternalInit()
@@ -227,8 +110,6 @@ void Core::InternalInit()
 		GetModuleFileName(dllModule_, selfpath, MAX_PATH);
 		LoadLibrary(selfpath);
 	}
-		
-	InitializeCriticalSection(&cs);
 
 	Direct3D9Hooks::i()->preCreateDeviceCallback([this](HWND hWnd){ PreCreateDevice(hWnd); });
 	Direct3D9Hooks::i()->postCreateDeviceCallback([this](IDirect3DDevice9* d, D3DPRESENT_PARAMETERS* pp){ PostCreateDevice(d, pp); });
@@ -240,6 +121,14 @@ void Core::InternalInit()
 	Direct3D9Hooks::i()->drawUnderCallback([this](IDirect3DDevice9* d, bool frameDrawn, bool sceneEnded){ DrawUnder(d, frameDrawn, sceneEnded); });
 	
 	imguiContext_ = ImGui::CreateContext();
+
+	// Before any keybind formats its display string
+	RefreshKeyNames();
+
+#ifdef GW2RADIAL_INPUT_RECORDER
+	// Created up front, since the window procedure only records once it exists
+	InputRecorder::i();
+#endif
 }
 
 void Core::OnFocusLost()
@@ -249,6 +138,17 @@ void Core::OnFocusLost()
 
 LRESULT Core::WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 {
+#ifdef GW2RADIAL_INPUT_RECORDER
+	if (auto r = InputRecorder::iNoInit(); r)
+		r->Record(msg, wParam, lParam);
+#endif
+
+	if (msg == WM_INPUTLANGCHANGE)
+	{
+		RefreshKeyNames();
+		Keybind::UpdateDisplayStrings();
+	}
+
 	if (msg == WM_KILLFOCUS)
 		i()->OnFocusLost();
 	else if(Input::i()->OnInput(msg, wParam, lParam))
@@ -298,6 +198,28 @@ void Core::PostCreateDevice(IDirect3DDevice9 *device, D3DPRESENT_PARAMETERS *pre
 	if(font_)
 		imio.FontDefault = font_;
 
+	if (!chatLog_)
+	{
+		ConfigurationOption<int> maxLines("Maximum chat lines", "max_lines", "Chat", 200);
+		ConfigurationOption<int> maxAge("Chat line lifetime (seconds)", "max_age", "Chat", 300);
+		ConfigurationOption<int> maxKilobytes("Maximum chat text size (KB)", "max_kb", "Chat", 256);
+
+		chatLog_ = std::make_unique<ChatLog>(ChatLog::Limits {
+			size_t(std::max(1, maxLines.value())),
+			mstime(std::max(0, maxAge.value())) * 1000,
+			size_t(std::max(1, maxKilobytes.value())) * 1024 });
+	}
+
+	if (!chatDedup_)
+	{
+		ConfigurationOption<int> dedupLines("Duplicate check lines", "dedup_lines", "Chat", 64);
+		ConfigurationOption<int> dedupWindow("Duplicate check window (seconds)", "dedup_window", "Chat", 30);
+
+		chatDedup_ = std::make_unique<ChatDedup>(ChatDedup::Limits {
+			size_t(std::max(1, dedupLines.value())),
+			mstime(std::max(0, dedupWindow.value())) * 1000 });
+	}
+
 	ImGui_ImplWin32_Init(gameWindow_);
 
 	OnDeviceSet(device, presentationParameters);
@@ -312,6 +234,8 @@ void Core::OnDeviceSet(IDirect3DDevice9 *device, D3DPRESENT_PARAMETERS *presenta
 void Core::OnDeviceUnset()
 {
 	ImGui_ImplDX9_InvalidateDeviceObjects();
+	chatView_.Invalidate();
+	Wheel::OnDeviceUnset();
 }
 
 void Core::PreReset()
@@ -331,8 +255,9 @@ void Core::DrawUnder(IDirect3DDevice9* device, bool frameDrawn, bool sceneEnded)
 
 void Core::DrawOver(IDirect3DDevice9* device, bool frameDrawn, bool sceneEnded)
 {
-	// This is the closest we have to a reliable "update" function, so use it as one
-	Input::i()->OnUpdate();
+	PROFILE_SCOPE("Core::DrawOver");
+
+	Clock::BeginFrame();
 
 	{
 		// We have to use Present rather than hooking EndScene because the game seems to do final UI compositing after EndScene
@@ -346,9 +271,19 @@ void Core::DrawOver(IDirect3DDevice9* device, bool frameDrawn, bool sceneEnded)
 		
 		////
 		DrawTextDatas();
+#ifdef GW2RADIAL_INPUT_RECORDER
+		DrawInputRecorder();
+#endif
+
+#ifdef GW2RADIAL_PROFILER
+		Profiler::DrawOverlay();
+#endif
 
 		ImGui::Render();
-		ImGui_ImplDX9_RenderDrawData(ImGui::GetDrawData());	
+		{
+			PROFILE_SCOPE("ImGui_ImplDX9_RenderDrawData");
+			ImGui_ImplDX9_RenderDrawData(ImGui::GetDrawData());
+		}
 
 		if (sceneEnded)
 			device->EndScene();
@@ -1,23 +1,123 @@
 #include "Effect.h"
 #include "Utility.h"
 #include <UnitQuad.h>
+#include <algorithm>
+#include <cstring>
 
 namespace GW2Radial {
 
+struct RenderStateSetting
+{
+	D3DRENDERSTATETYPE state;
+	DWORD value;
+};
+
+struct SamplerStateSetting
+{
+	DWORD sampler;
+	D3DSAMPLERSTATETYPE state;
+	DWORD value;
+};
+
+// Everything SceneBegin sets up, which together with what the techniques, textures, viewport and
+// variables touch while drawing is exactly what the state block saves and restores
+static const RenderStateSetting sceneRenderStates[] = {
+	{ D3DRS_ZENABLE, 0 },
+	{ D3DRS_ZWRITEENABLE, 0 },
+	{ D3DRS_CULLMODE, D3DCULL_NONE },
+	{ D3DRS_ALPHATESTENABLE, 0 },
+	{ D3DRS_ALPHABLENDENABLE, 1 },
+	{ D3DRS_BLENDOP, D3DBLENDOP_ADD },
+};
+
+static const SamplerStateSetting sceneSamplerStates[] = {
+	{ 0, D3DSAMP_ADDRESSU, D3DTADDRESS_CLAMP },
+	{ 0, D3DSAMP_ADDRESSV, D3DTADDRESS_CLAMP },
+	{ 0, D3DSAMP_MINFILTER, D3DTEXF_LINEAR },
+	{ 0, D3DSAMP_MAGFILTER, D3DTEXF_LINEAR },
+	{ 0, D3DSAMP_MIPFILTER, D3DTEXF_LINEAR },
+
+	{ 1, D3DSAMP_ADDRESSU, D3DTADDRESS_MIRROR },
+	{ 1, D3DSAMP_ADDRESSV, D3DTADDRESS_MIRROR },
+	{ 1, D3DSAMP_MINFILTER, D3DTEXF_LINEAR },
+	{ 1, D3DSAMP_MAGFILTER, D3DTEXF_LINEAR },
+	{ 1, D3DSAMP_MIPFILTER, D3DTEXF_LINEAR },
+
+	{ 2, D3DSAMP_ADDRESSU, D3DTADDRESS_CLAMP },
+	{ 2, D3DSAMP_ADDRESSV, D3DTADDRESS_CLAMP },
+	{ 2, D3DSAMP_MINFILTER, D3DTEXF_LINEAR },
+	{ 2, D3DSAMP_MAGFILTER, D3DTEXF_LINEAR },
+	{ 2, D3DSAMP_MIPFILTER, D3DTEXF_LINEAR },
+};
+
+// Changed by SetTechnique
+static const D3DRENDERSTATETYPE techniqueRenderStates[] = { D3DRS_SRCBLEND, D3DRS_DESTBLEND };
+
+// One per EffectTextureSlot
+static const DWORD textureStageCount = 3;
+
 Effect::Effect(IDirect3DDevice9 * iDev)
 {
 	dev = iDev;
+	sb = NULL;
 
-	iDev->CreateStateBlock(D3DSBT_ALL, &sb);
+	// Only the states set while recording are part of the block, so capturing and applying it
+	// touches those rather than the whole device, as a D3DSBT_ALL block would
+	if (SUCCEEDED(iDev->BeginStateBlock()))
+	{
+		RecordTouchedStates();
+		if (FAILED(iDev->EndStateBlock(&sb)))
+			sb = NULL;
+	}
 
 	ps = NULL;
 	vs = NULL;
+	vsInstanced = NULL;
+}
+
+void Effect::RecordTouchedStates()
+{
+	// The values are irrelevant, Capture replaces them with the device's
+	for (const auto& rs : sceneRenderStates)
+		dev->SetRenderState(rs.state, rs.value);
+	for (auto state : techniqueRenderStates)
+		dev->SetRenderState(state, D3DBLEND_ONE);
+	for (const auto& ss : sceneSamplerStates)
+		dev->SetSamplerState(ss.sampler, ss.state, ss.value);
+	for (DWORD stage = 0; stage < textureStageCount; stage++)
+		dev->SetTexture(stage, nullptr);
+
+	dev->SetPixelShader(nullptr);
+	dev->SetVertexShader(nullptr);
+
+	// A null declaration is not a valid argument, so record UnitQuad's own
+	IDirect3DVertexDeclaration9* vdcl = NULL;
+	if (SUCCEEDED(dev->CreateVertexDeclaration(UnitQuad::def(), &vdcl)))
+	{
+		dev->SetVertexDeclaration(vdcl);
+		vdcl->Release();
+	}
+	// Stream 1 and the frequencies are only changed by InstancedQuad
+	for (uint stream = 0; stream < 2; stream++)
+	{
+		dev->SetStreamSource(stream, nullptr, 0, 0);
+		dev->SetStreamSourceFreq(stream, 1);
+	}
+	dev->SetIndices(nullptr);
+
+	D3DVIEWPORT9 vp = { 0, 0, 1, 1, 0.f, 1.f };
+	dev->SetViewport(&vp);
+
+	const std::array<float, ConstantRegisters::Count * 4> zero { };
+	dev->SetVertexShaderConstantF(0, zero.data(), ConstantRegisters::Count);
+	dev->SetPixelShaderConstantF(0, zero.data(), ConstantRegisters::Count);
 }
 
 Effect::~Effect()
 {
 	COM_RELEASE(ps);
 	COM_RELEASE(vs);
+	COM_RELEASE(vsInstanced);
 	COM_RELEASE(sb);
 }
 
@@ -32,6 +132,10 @@ int Effect::Load()
 	if (LoadFontResource(IDR_SHADER_VS, code, sz))
 		dev->CreateVertexShader((DWORD*)code, &vs);
 
+	// Optional, elements fall back to one draw each without it
+	if (LoadFontResource(IDR_SHADER_INSTANCED_VS, code, sz))
+		dev->CreateVertexShader((DWORD*)code, &vsInstanced);
+
 	return (ps && vs);
 }
 
@@ -72,14 +176,11 @@ void Effect::SetFloat(EffectVarSlot slot, float fv)
 	SetVarToSlot(slot, &fv, 4);
 }
 
-static float floatArrayFiller[12 * 4] = { 0 };
-
 void Effect::SetFloatArray(EffectVarSlot slot, float * fv, int sz)
-{	
+{
+	// Arrays are laid out one element per register, in its x component
 	for (int i = 0; i != sz; ++i)
-		floatArrayFiller[i * 4] = fv[i];
-
-	SetVarToSlot(slot, floatArrayFiller, sz*16);
+		SetVarToSlot(slot, fv + i, 4, i);
 }
 
 void Effect::SetTexture(EffectTextureSlot slot, IDirect3DTexture9 * val)
@@ -87,37 +188,24 @@ void Effect::SetTexture(EffectTextureSlot slot, IDirect3DTexture9 * val)
 	dev->SetTexture(slot, val);
 }
 
+void Effect::SetInstanced(bool enabled)
+{
+	dev->SetVertexShader(enabled && vsInstanced ? vsInstanced : vs);
+}
+
 void Effect::SceneBegin(void* drawBuf)
 {
-	sb->Capture();
+	if (sb)
+		sb->Capture();
+	InvalidateConstants();
 
 	//megai2: FIXME set UnitQuad* type to method parameter and make it compile
 	((UnitQuad*)drawBuf)->Bind();
 
-	dev->SetSamplerState(0, D3DSAMP_ADDRESSU, D3DTADDRESS_CLAMP);
-	dev->SetSamplerState(0, D3DSAMP_ADDRESSV, D3DTADDRESS_CLAMP);
-	dev->SetSamplerState(0, D3DSAMP_MINFILTER, D3DTEXF_LINEAR);
-	dev->SetSamplerState(0, D3DSAMP_MAGFILTER, D3DTEXF_LINEAR);
-	dev->SetSamplerState(0, D3DSAMP_MIPFILTER, D3DTEXF_LINEAR);
-
-	dev->SetSamplerState(1, D3DSAMP_ADDRESSU, D3DTADDRESS_MIRROR);
-	dev->SetSamplerState(1, D3DSAMP_ADDRESSV, D3DTADDRESS_MIRROR);
-	dev->SetSamplerState(1, D3DSAMP_MINFILTER, D3DTEXF_LINEAR);
-	dev->SetSamplerState(1, D3DSAMP_MAGFILTER, D3DTEXF_LINEAR);
-	dev->SetSamplerState(1, D3DSAMP_MIPFILTER, D3DTEXF_LINEAR);
-
-	dev->SetSamplerState(2, D3DSAMP_ADDRESSU, D3DTADDRESS_CLAMP);
-	dev->SetSamplerState(2, D3DSAMP_ADDRESSV, D3DTADDRESS_CLAMP);
-	dev->SetSamplerState(2, D3DSAMP_MINFILTER, D3DTEXF_LINEAR);
-	dev->SetSamplerState(2, D3DSAMP_MAGFILTER, D3DTEXF_LINEAR);
-	dev->SetSamplerState(2, D3DSAMP_MIPFILTER, D3DTEXF_LINEAR);
-
-	dev->SetRenderState(D3DRS_ZENABLE, 0);
-	dev->SetRenderState(D3DRS_ZWRITEENABLE, 0);
-	dev->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
-	dev->SetRenderState(D3DRS_ALPHATESTENABLE, 0);
-	dev->SetRenderState(D3DRS_ALPHABLENDENABLE, 1);
-	dev->SetRenderState(D3DRS_BLENDOP, D3DBLENDOP_ADD);
+	for (const auto& ss : sceneSamplerStates)
+		dev->SetSamplerState(ss.sampler, ss.state, ss.value);
+	for (const auto& rs : sceneRenderStates)
+		dev->SetRenderState(rs.state, rs.value);
 
 	dev->SetPixelShader(ps);
 	dev->SetVertexShader(vs);
@@ -125,12 +213,13 @@ void Effect::SceneBegin(void* drawBuf)
 
 void Effect::SceneEnd()
 {
-	sb->Apply();
+	if (sb)
+		sb->Apply();
 }
 
 void Effect::BeginPass(int whatever)
 {
-
+	CommitChanges();
 }
 
 void Effect::Begin(uint * pass, int whatever)
@@ -145,7 +234,7 @@ void Effect::End()
 {
 }
 
-void Effect::SetVarToSlot(EffectVarSlot slot, float* mem, int sz)
+void Effect::SetVarToSlot(EffectVarSlot slot, float* mem, int sz, int regOffset)
 {
 	static int tgtType[] = {
 		1,//EFF_VS_INK_SPOT,
@@ -156,9 +245,10 @@ void Effect::SetVarToSlot(EffectVarSlot slot, float* mem, int sz)
 		0,//EFF_VS_SPRITE_DIM,
 		1,//EFF_VS_HOVER_FADEINS,
 		2,//EFF_VS_SCREEN_SIZE,
-		1,//EFF_VS_ELEMENT_ID,
-		1,//EFF_VS_ELEMENT_COLOR,
+		0,//EFF_VS_ELEMENT_PARAMS,
+		0,//EFF_VS_ELEMENT_COLOR,
 		1,//EFF_VS_TECH_ID
+		0,//EFF_VS_ELEMENT_UV_RECT
 	};
 
 	static int tgtReg[] = {
@@ -170,42 +260,69 @@ void Effect::SetVarToSlot(EffectVarSlot slot, float* mem, int sz)
 		0,//EFF_VS_SPRITE_DIM,
 		8,//EFF_VS_HOVER_FADEINS,
 	   -1,//EFF_VS_SCREEN_SIZE,
-		5,//EFF_VS_ELEMENT_ID,
-		6,//EFF_VS_ELEMENT_COLOR,
+		3,//EFF_VS_ELEMENT_PARAMS,
+		2,//EFF_VS_ELEMENT_COLOR,
 		7,//EFF_VS_TECH_ID
+		1,//EFF_VS_ELEMENT_UV_RECT
 	};
 
-	float fv4t[4];
+	if (tgtType[slot] == 0)
+		vsConsts.Write(tgtReg[slot] + regOffset, mem, sz / 4);
+	else if (tgtType[slot] == 1)
+		psConsts.Write(tgtReg[slot] + regOffset, mem, sz / 4);
+}
+
+void Effect::ConstantRegisters::Write(uint reg, const float* data, uint floatCount)
+{
+	if (reg >= Count)
+		return;
+	floatCount = std::min(floatCount, (Count - reg) * 4);
 
-	if (sz < 16)
+	// Partially written registers keep their other components, rather than whatever happened to be on the stack
+	for (uint i = 0; i < floatCount; i += 4)
 	{
-		sz = sz / 4;
-		for (int i = 0; i != sz; ++i)
-			fv4t[i] = mem[i];
-		mem = fv4t;
-		sz = 1;
+		const uint r = reg + i / 4;
+		const uint n = std::min(4u, floatCount - i);
+		float* dst = &values[r * 4];
+
+		const bool changed = memcmp(dst, data + i, n * sizeof(float)) != 0;
+		if (changed || !(uploaded >> r & 1))
+			dirty |= 1u << r;
+		if (changed)
+			memcpy(dst, data + i, n * sizeof(float));
 	}
-	else if (sz & 0xC)
-	{
-		int rem = (sz & 0xC) >> 2;
-		sz = sz >> 2;
-
-		for (int i = 0; i != rem; ++i)
-			fv4t[i] = mem[i+sz];
+}
 
-		sz = sz >> 2;
+void Effect::CommitChanges()
+{
+	CommitChanges(vsConsts, true);
+	CommitChanges(psConsts, false);
+}
 
-		if (tgtType[slot] == 0)
-			dev->SetVertexShaderConstantF(tgtReg[slot]+sz, fv4t, 1);
-		else if (tgtType[slot] == 1)
-			dev->SetPixelShaderConstantF(tgtReg[slot]+sz, fv4t, 1);
-	} else 
-		sz = sz >> 4;
+void Effect::CommitChanges(ConstantRegisters& regs, bool vertexShader)
+{
+	for (uint first = 0; first < ConstantRegisters::Count;)
+	{
+		if (!(regs.dirty >> first & 1))
+		{
+			first++;
+			continue;
+		}
+
+		uint last = first;
+		while (last < ConstantRegisters::Count && (regs.dirty >> last & 1))
+			last++;
+
+		if (vertexShader)
+			dev->SetVertexShaderConstantF(first, &regs.values[first * 4], last - first);
+		else
+			dev->SetPixelShaderConstantF(first, &regs.values[first * 4], last - first);
+
+		first = last;
+	}
 
-	if (tgtType[slot] == 0)
-		dev->SetVertexShaderConstantF(tgtReg[slot], (float*)mem, sz);
-	else if (tgtType[slot] == 1)
-		dev->SetPixelShaderConstantF(tgtReg[slot], (float*)mem, sz);
+	regs.uploaded |= regs.dirty;
+	regs.dirty = 0;
 }
 
 }
\ No newline at end of file
@@ -136,6 +136,7 @@ void Effect_dx12::SceneBegin(void * drawBuf)
 {
 	//megai2: mark draw start so we can see that app is issuing some not default dx9 api approach
 	dev->SetRenderState(D3DRS_D912PXY_DRAW, 0);
+	InvalidateConstants();
 
 	//setup saved sampler by writing directly into gpu buffer
 	dev->SetRenderState(D3DRS_D912PXY_GPU_WRITE, D912PXY_ENCODE_GPU_WRITE_DSC(1, D912PXY_GPU_WRITE_OFFSET_SAMPLER));
@@ -157,6 +158,7 @@ void Effect_dx12::SceneEnd()
 
 void Effect_dx12::BeginPass(int whatever)
 {
+	CommitChanges();
 }
 
 void Effect_dx12::Begin(uint * pass, int whatever)
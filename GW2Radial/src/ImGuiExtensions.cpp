@@ -86,7 +86,7 @@ void ImGuiKeybindInput(GW2Radial::Keybind& setting)
 	else if (setting.isBeingModified() && ImGui::Button(("Clear" + suffix).c_str(), ImVec2(windowWidth * 0.1f, 0.f)))
 	{
 		setting.isBeingModified(false);
-		setting.keys(std::set<uint>());
+		setting.keys(GW2Radial::KeyCombo());
 	}
 
 	ImGui::SameLine();
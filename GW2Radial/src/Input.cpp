@@ -4,6 +4,9 @@
 #include <Core.h>
 #include <algorithm>
 #include <SettingsMenu.h>
+#include <Profiler.h>
+#include <RawInput.h>
+#include <cstddef>
 
 IMGUI_IMPL_API LRESULT  ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
@@ -13,7 +16,8 @@ namespace GW2Radial
 DEFINE_SINGLETON(Input);
 
 Input::Input()
-	: distinguishLeftRight_("Distinguish between left and right Shift/Ctrl/Alt", "distinguish_lr", "Core", false)
+	: scheduler_(Clock::system(), [](const InputScheduler::Message& m) { PostMessage(HWND(m.window), m.msg, WPARAM(m.wParam), LPARAM(m.lParam)); })
+	, distinguishLeftRight_("Distinguish between left and right Shift/Ctrl/Alt", "distinguish_lr", "Core", false)
 {
 	id_H_LBUTTONDOWN_ = RegisterWindowMessage(TEXT("H_LBUTTONDOWN"));
 	id_H_LBUTTONUP_   = RegisterWindowMessage(TEXT("H_LBUTTONUP"));
@@ -30,123 +34,54 @@ Input::Input()
 	id_H_MOUSEMOVE_   = RegisterWindowMessage(TEXT("H_MOUSEMOVE"));
 }
 
-WPARAM MapLeftRightKeys(WPARAM vk, LPARAM lParam)
+// Reads the header straight into RawInputHeader, which mirrors RAWINPUTHEADER
+class SystemRawInput : public RawInputSource
 {
-    WPARAM newVk = vk;
-    const UINT scancode = (lParam & 0x00ff0000) >> 16;
-    const int extended  = (lParam & 0x01000000) != 0;
-
-    switch (vk) {
-    case VK_SHIFT:
-        newVk = MapVirtualKey(scancode, MAPVK_VSC_TO_VK_EX);
-        break;
-    case VK_CONTROL:
-        newVk = extended ? VK_RCONTROL : VK_LCONTROL;
-        break;
-    case VK_MENU:
-        newVk = extended ? VK_RMENU : VK_LMENU;
-        break;
-    default:
-        // not a key we map from generic to left/right specialized
-        //  just return it.
-        newVk = vk;
-        break;    
-    }
-
-    return newVk;
-}
-
-bool IsRawInputMouse(LPARAM lParam)
-{
-	UINT dwSize = 40;
-	static BYTE lpb[40];
-
-	GetRawInputData(reinterpret_cast<HRAWINPUT>(lParam), RID_INPUT,
-		lpb, &dwSize, sizeof(RAWINPUTHEADER));
+public:
+	bool Header(uintptr_t handle, RawInputHeader& header) const override
+	{
+		static_assert(sizeof(RawInputHeader) == sizeof(RAWINPUTHEADER));
+		static_assert(offsetof(RawInputHeader, device) == offsetof(RAWINPUTHEADER, hDevice));
+		static_assert(RawInputHeader::Mouse == RIM_TYPEMOUSE);
 
-	auto* raw = reinterpret_cast<RAWINPUT*>(lpb);
+		UINT size = sizeof(header);
+		return GetRawInputData(reinterpret_cast<HRAWINPUT>(handle), RID_HEADER, &header, &size, sizeof(RAWINPUTHEADER)) != UINT(-1);
+	}
+};
 
-	return raw->header.dwType == RIM_TYPEMOUSE;
-}
+static const SystemRawInput systemRawInput;
 
 bool Input::OnInput(UINT& msg, WPARAM& wParam, LPARAM& lParam)
 {
-	std::list<EventKey> eventKeys;
+	PROFILE_SCOPE("Input::OnInput");
+
+	const auto eventKeys = InputDispatcher::Translate(msg, wParam, lParam, distinguishLeftRight_.value());
 
-	// Generate our EventKey list for the current message
+	// Classifying raw input costs a system call, so only do it once something needs to know
+	std::optional<bool> isRawInputMouseCache;
+	const auto isRawInputMouse = [&]()
 	{
-		bool eventDown = false;
-		switch (msg)
-		{
-		case WM_SYSKEYDOWN:
-		case WM_KEYDOWN:
-			eventDown = true;
-		case WM_SYSKEYUP:
-		case WM_KEYUP:
+		if(!isRawInputMouseCache)
+			isRawInputMouseCache = msg == WM_INPUT && IsRawInputMouse(systemRawInput, uintptr_t(lParam));
+		return *isRawInputMouseCache;
+	};
+
+	InputResponse response = InputResponse::PASS_TO_GAME;
+	{
+		std::lock_guard<std::mutex> lock(dispatchMutex_);
+		// A running replay has the callbacks to itself, so live input goes to the game untouched meanwhile
+		if (!replay_)
 		{
-			const uint key = distinguishLeftRight_.value() ? uint(MapLeftRightKeys(wParam, lParam)) : uint(wParam);
-			if ((msg == WM_SYSKEYDOWN || msg == WM_SYSKEYUP) && wParam != VK_F10)
-			{
-				if (((lParam >> 29) & 1) == 1)
-					eventKeys.push_back({ key, true });
-				else
-					eventKeys.push_back({ key, false });
-			}
-
-			eventKeys.push_back({ key, eventDown });
-			break;
-		}
-		case WM_LBUTTONDOWN:
-			eventDown = true;
-		case WM_LBUTTONUP:
-			eventKeys.push_back({ VK_LBUTTON, eventDown });
-			break;
-		case WM_MBUTTONDOWN:
-			eventDown = true;
-		case WM_MBUTTONUP:
-			eventKeys.push_back({ VK_MBUTTON, eventDown });
-			break;
-		case WM_RBUTTONDOWN:
-			eventDown = true;
-		case WM_RBUTTONUP:
-			eventKeys.push_back({ VK_RBUTTON, eventDown });
-			break;
-		case WM_XBUTTONDOWN:
-			eventDown = true;
-		case WM_XBUTTONUP:
-			eventKeys.push_back({ uint(GET_XBUTTON_WPARAM(wParam) == XBUTTON1 ? VK_XBUTTON1 : VK_XBUTTON2), eventDown });
-			break;
+			const bool mouseMoved = dispatcher_.wantsMouseMoves() && (msg == WM_MOUSEMOVE || isRawInputMouse());
+			response = dispatcher_.Dispatch(eventKeys, mouseMoved);
 		}
 	}
 
-	const auto isRawInputMouse = msg == WM_INPUT && IsRawInputMouse(lParam);
-
-	bool preventMouseMove = false;
-	if(msg == WM_MOUSEMOVE || isRawInputMouse)
-		for(auto& cb : mouseMoveCallbacks_)
-			preventMouseMove |= (*cb)();
-
-	bool downKeysChanged = false;
-
-	// Apply key events now
-	for (const auto& k : eventKeys)
-		if (k.down)
-			downKeysChanged |= DownKeys.insert(k.vk).second;
-		else
-			downKeysChanged |= DownKeys.erase(k.vk) > 0;
-
-
-	InputResponse response = InputResponse::PASS_TO_GAME;
-	// Only run these for key down/key up (incl. mouse buttons) events
-	if(!eventKeys.empty())
-		for(auto& cb : inputChangeCallbacks_)
-			response |= (*cb)(downKeysChanged, DownKeys, eventKeys);
-
 #if 0
 	if (input_key_down || input_key_up)
 	{
 		std::string keybind = "";
-		for (const auto& k : DownKeys)
+		for (const auto& k : dispatcher_.downKeys())
 		{
 			keybind += GetKeyName(k) + std::string(" + ");
 		}
@@ -171,14 +106,14 @@ bool Input::OnInput(UINT& msg, WPARAM& wParam, LPARAM& lParam)
 	if(response == InputResponse::PREVENT_ALL)
 		return true;
 
-	if(response == InputResponse::PREVENT_MOUSE || preventMouseMove)
+	if(response == InputResponse::PREVENT_MOUSE)
 	{
 		switch (msg)
 		{
 		case WM_MOUSEMOVE:
 			return true;
 		case WM_INPUT:
-			if(isRawInputMouse)
+			if(isRawInputMouse())
 				return true;
 			break;
 		case WM_LBUTTONDOWN:
@@ -247,12 +182,62 @@ bool Input::OnInput(UINT& msg, WPARAM& wParam, LPARAM& lParam)
 
 void Input::OnFocusLost()
 {
-	DownKeys.clear();
+	std::lock_guard<std::mutex> lock(dispatchMutex_);
+	dispatcher_.ClearDownKeys();
+}
+
+void Input::AddMouseMoveCallback(MouseMoveCallback* cb)
+{
+	std::lock_guard<std::mutex> lock(dispatchMutex_);
+	dispatcher_.AddMouseMoveCallback(cb);
+}
+
+void Input::AddInputChangeCallback(InputChangeCallback* cb)
+{
+	std::lock_guard<std::mutex> lock(dispatchMutex_);
+	dispatcher_.AddInputChangeCallback(cb);
 }
 
-void Input::OnUpdate()
+void Input::RemoveMouseMoveCallback(MouseMoveCallback* cb)
 {
-	SendQueuedInputs();
+	std::lock_guard<std::mutex> lock(dispatchMutex_);
+	dispatcher_.RemoveMouseMoveCallback(cb);
+	if (replay_)
+		replay_->dispatcher().RemoveMouseMoveCallback(cb);
+}
+
+void Input::RemoveInputChangeCallback(InputChangeCallback* cb)
+{
+	std::lock_guard<std::mutex> lock(dispatchMutex_);
+	dispatcher_.RemoveInputChangeCallback(cb);
+	if (replay_)
+		replay_->dispatcher().RemoveInputChangeCallback(cb);
+}
+
+InputReplay::Report Input::Replay(const std::vector<InputRecord>& records)
+{
+	InputReplay replay(distinguishLeftRight_.value());
+	{
+		std::lock_guard<std::mutex> lock(dispatchMutex_);
+		if (replay_)
+		{
+			InputReplay::Report busy;
+			busy.error = L"Another replay is still running";
+			return busy;
+		}
+
+		replay.dispatcher().AddCallbacks(dispatcher_);
+		replay_ = &replay;
+	}
+
+	auto report = replay.Run(records, &dispatchMutex_);
+
+	std::lock_guard<std::mutex> lock(dispatchMutex_);
+	replay_ = nullptr;
+	// Keys went up and down unseen while the replay had the callbacks
+	dispatcher_.ClearDownKeys();
+
+	return report;
 }
 
 uint Input::ConvertHookedMessage(uint msg) const
@@ -287,11 +272,11 @@ uint Input::ConvertHookedMessage(uint msg) const
 	return msg;
 }
 
-Input::DelayedInput Input::TransformVKey(uint vk, bool down, mstime t, const std::optional<Point>& cursorPos)
+InputScheduler::Message Input::TransformVKey(uint vk, bool down, int64_t due, const std::optional<Point>& cursorPos)
 {
-	DelayedInput i { };
-	i.t = t;
-	i.cursorPos = cursorPos;
+	InputScheduler::Message i { };
+	i.window = Core::i()->gameWindow();
+	i.due = due;
 	if (vk == VK_LBUTTON || vk == VK_MBUTTON || vk == VK_RBUTTON || vk == VK_XBUTTON1 || vk == VK_XBUTTON2)
 	{
 		std::tie(i.wParam, i.lParam) = CreateMouseEventParams(cursorPos);
@@ -353,20 +338,22 @@ Input::DelayedInput Input::TransformVKey(uint vk, bool down, mstime t, const std
 
 std::tuple<WPARAM, LPARAM> Input::CreateMouseEventParams(const std::optional<Point>& cursorPos) const
 {
+	const auto& downKeys = dispatcher_.downKeys();
+
 	WPARAM wParam = 0;
-	if (DownKeys.count(VK_CONTROL) || DownKeys.count(VK_LCONTROL) || DownKeys.count(VK_RCONTROL))
+	if (downKeys.count(VK_CONTROL) || downKeys.count(VK_LCONTROL) || downKeys.count(VK_RCONTROL))
 		wParam += MK_CONTROL;
-	if (DownKeys.count(VK_SHIFT) || DownKeys.count(VK_LSHIFT) || DownKeys.count(VK_RSHIFT))
+	if (downKeys.count(VK_SHIFT) || downKeys.count(VK_LSHIFT) || downKeys.count(VK_RSHIFT))
 		wParam += MK_SHIFT;
-	if (DownKeys.count(VK_LBUTTON))
+	if (downKeys.count(VK_LBUTTON))
 		wParam += MK_LBUTTON;
-	if (DownKeys.count(VK_RBUTTON))
+	if (downKeys.count(VK_RBUTTON))
 		wParam += MK_RBUTTON;
-	if (DownKeys.count(VK_MBUTTON))
+	if (downKeys.count(VK_MBUTTON))
 		wParam += MK_MBUTTON;
-	if (DownKeys.count(VK_XBUTTON1))
+	if (downKeys.count(VK_XBUTTON1))
 		wParam += MK_XBUTTON1;
-	if (DownKeys.count(VK_XBUTTON2))
+	if (downKeys.count(VK_XBUTTON2))
 		wParam += MK_XBUTTON2;
 
 	const auto& io = ImGui::GetIO();
@@ -375,65 +362,30 @@ std::tuple<WPARAM, LPARAM> Input::CreateMouseEventParams(const std::optional<Poi
 	return { wParam, lParam };
 }
 
-void Input::SendKeybind(const std::set<uint> &vkeys, const std::optional<Point>& cursorPos)
+void Input::SendKeybind(const KeyCombo &vkeys, const std::optional<Point>& cursorPos)
 {
-	if (vkeys.empty())
-		return;
-
-	std::list<uint> vkeysSorted(vkeys.begin(), vkeys.end());
-	vkeysSorted.sort([](uint &a, uint &b)
-	{
-		if (std::set<uint>{ VK_CONTROL, VK_LCONTROL, VK_RCONTROL, VK_SHIFT, VK_LSHIFT, VK_RSHIFT, VK_MENU, VK_LMENU, VK_RMENU }.count(a))
-			return true;
-		else
-			return a < b;
-	});
-
-	mstime currentTime = TimeInMilliseconds() + 10;
-
-	for (const auto &vk : vkeysSorted)
-	{
-		if (DownKeys.count(vk))
-			continue;
-
-		DelayedInput i = TransformVKey(vk, true, currentTime, cursorPos);
-		QueuedInputs.push_back(i);
-		currentTime += 20;
-	}
-
-	currentTime += 50;
-
-	for (const auto &vk : reverse(vkeysSorted))
+	// Callbacks run by a replay only get to add the keys to its report
+	if (auto* replay = InputReplay::running())
 	{
-		if (DownKeys.count(vk))
-			continue;
-
-		DelayedInput i = TransformVKey(vk, false, currentTime, cursorPos);
-		QueuedInputs.push_back(i);
-		currentTime += 20;
-	}
-}
-
-void Input::SendQueuedInputs()
-{
-	if (QueuedInputs.empty())
+		replay->SendKeybind(vkeys);
 		return;
+	}
 
-	const auto currentTime = TimeInMilliseconds();
-
-	auto &qi = QueuedInputs.front();
-
-	if (currentTime < qi.t)
+	// Keys already held are left alone
+	const KeyCombo keys = vkeys - dispatcher_.downKeys();
+	if (keys.empty())
 		return;
 
-	if (qi.cursorPos)
+	// Mouse event parameters are captured now rather than when the scheduler thread sends them
+	InputScheduler::SequenceKeybind(keys, scheduler_.clock(), [&](uint vk, bool down, int64_t due)
 	{
-		auto [wParam, lParam] = CreateMouseEventParams(qi.cursorPos);
-		PostMessage(Core::i()->gameWindow(), id_H_MOUSEMOVE_, wParam, lParam);
-	}
-
-	PostMessage(Core::i()->gameWindow(), qi.msg, qi.wParam, qi.lParam);
+		if (cursorPos)
+		{
+			auto [wParam, lParam] = CreateMouseEventParams(cursorPos);
+			scheduler_.Schedule({ Core::i()->gameWindow(), id_H_MOUSEMOVE_, wParam, lParam, due });
+		}
 
-	QueuedInputs.pop_front();
+		scheduler_.Schedule(TransformVKey(vk, down, due, cursorPos));
+	});
 }
 }
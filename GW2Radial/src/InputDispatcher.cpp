@@ -0,0 +1,99 @@
+#include <InputDispatcher.h>
+#include <Main.h>
+
+namespace GW2Radial
+{
+
+static uint MapLeftRightKeys(uint vk, intptr_t lParam)
+{
+	const uint scancode = (lParam & 0x00ff0000) >> 16;
+	const bool extended = (lParam & 0x01000000) != 0;
+
+	switch (vk)
+	{
+	case VK_SHIFT:
+		// Both shifts share the generic key; only the right one has its own scan code
+		return scancode == 0x36 ? VK_RSHIFT : VK_LSHIFT;
+	case VK_CONTROL:
+		return extended ? VK_RCONTROL : VK_LCONTROL;
+	case VK_MENU:
+		return extended ? VK_RMENU : VK_LMENU;
+	default:
+		return vk;
+	}
+}
+
+EventKeys InputDispatcher::Translate(uint msg, uintptr_t wParam, intptr_t lParam, bool distinguishLeftRight)
+{
+	EventKeys eventKeys;
+
+	bool eventDown = false;
+	switch (msg)
+	{
+	case WM_SYSKEYDOWN:
+	case WM_KEYDOWN:
+		eventDown = true;
+	case WM_SYSKEYUP:
+	case WM_KEYUP:
+	{
+		const uint key = distinguishLeftRight ? MapLeftRightKeys(uint(wParam), lParam) : uint(wParam);
+		if ((msg == WM_SYSKEYDOWN || msg == WM_SYSKEYUP) && wParam != VK_F10)
+		{
+			if (((lParam >> 29) & 1) == 1)
+				eventKeys.push_back({ key, true });
+			else
+				eventKeys.push_back({ key, false });
+		}
+
+		eventKeys.push_back({ key, eventDown });
+		break;
+	}
+	case WM_LBUTTONDOWN:
+		eventDown = true;
+	case WM_LBUTTONUP:
+		eventKeys.push_back({ VK_LBUTTON, eventDown });
+		break;
+	case WM_MBUTTONDOWN:
+		eventDown = true;
+	case WM_MBUTTONUP:
+		eventKeys.push_back({ VK_MBUTTON, eventDown });
+		break;
+	case WM_RBUTTONDOWN:
+		eventDown = true;
+	case WM_RBUTTONUP:
+		eventKeys.push_back({ VK_RBUTTON, eventDown });
+		break;
+	case WM_XBUTTONDOWN:
+		eventDown = true;
+	case WM_XBUTTONUP:
+		eventKeys.push_back({ uint(GET_XBUTTON_WPARAM(wParam) == XBUTTON1 ? VK_XBUTTON1 : VK_XBUTTON2), eventDown });
+		break;
+	}
+
+	return eventKeys;
+}
+
+InputResponse InputDispatcher::Dispatch(const EventKeys& eventKeys, bool mouseMoved)
+{
+	bool preventMouseMove = false;
+	if (mouseMoved)
+		for (auto* cb : mouseMoveCallbacks_)
+			preventMouseMove |= (*cb)();
+
+	bool downKeysChanged = false;
+	for (const auto& k : eventKeys)
+		if (k.down)
+			downKeysChanged |= downKeys_.insert(k.vk).second;
+		else
+			downKeysChanged |= downKeys_.erase(k.vk) > 0;
+
+	InputResponse response = preventMouseMove ? InputResponse::PREVENT_MOUSE : InputResponse::PASS_TO_GAME;
+	// Only run these for key down/key up (incl. mouse buttons) events
+	if (!eventKeys.empty())
+		for (auto* cb : inputChangeCallbacks_)
+			response |= (*cb)(downKeysChanged, downKeys_, eventKeys);
+
+	return response;
+}
+
+}
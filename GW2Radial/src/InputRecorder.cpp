@@ -0,0 +1,185 @@
+#include <InputRecorder.h>
+#include <Input.h>
+#include <ConfigurationFile.h>
+#include <Utility.h>
+#include <imgui.h>
+#include <algorithm>
+#include <thread>
+
+#ifdef GW2RADIAL_INPUT_RECORDER
+
+namespace GW2Radial
+{
+DEFINE_SINGLETON(InputRecorder);
+
+InputRecorder::~InputRecorder()
+{
+	Stop();
+}
+
+bool InputRecorder::Start(const std::wstring& path)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (file_)
+		return false;
+
+	if (_wfopen_s(&file_, path.c_str(), L"wb") != 0)
+	{
+		file_ = nullptr;
+		return false;
+	}
+
+	RecordingHeader header { };
+	std::copy(std::begin(RecordingHeader::Magic), std::end(RecordingHeader::Magic), header.magic);
+	header.version = RecordingHeader::Version;
+	fwrite(&header, sizeof(header), 1, file_);
+
+	buffer_.reserve(FlushThreshold);
+	recordedCount_ = 0;
+	recordStart_ = Clock::microseconds();
+	recording_ = true;
+
+	return true;
+}
+
+void InputRecorder::Stop()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	recording_ = false;
+	if (!file_)
+		return;
+
+	Flush();
+	fclose(file_);
+	file_ = nullptr;
+}
+
+void InputRecorder::Flush()
+{
+	if (!buffer_.empty())
+		fwrite(buffer_.data(), sizeof(InputRecord), buffer_.size(), file_);
+	buffer_.clear();
+}
+
+void InputRecorder::Record(uint msg, WPARAM wParam, LPARAM lParam)
+{
+	if (!recording())
+		return;
+
+	// Typed text and anything else the replay would ignore never reaches the disk
+	const auto converted = Input::i()->ConvertHookedMessage(msg);
+	if (!InputReplay::Replayable(converted))
+		return;
+
+	const auto now = Clock::microseconds();
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (!file_)
+		return;
+
+	buffer_.push_back({ uint64_t(now - recordStart_), converted, converted != msg ? InputRecord::Synthetic : 0u, uint64_t(wParam), uint64_t(lParam) });
+	recordedCount_++;
+
+	// Writes are batched so the window procedure only occasionally waits on the disk
+	if (buffer_.size() >= FlushThreshold)
+		Flush();
+}
+
+void InputRecorder::StartReplay(const std::wstring& path)
+{
+	if (replaying_.exchange(true))
+		return;
+
+	// Detached like the scheduler's thread, since joining it from the destructor could happen under the loader lock
+	std::thread([this, path]
+	{
+		auto report = Replay(path);
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			lastReport_ = std::move(report);
+		}
+		replaying_ = false;
+	}).detach();
+}
+
+InputRecorder::Report InputRecorder::lastReport() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return lastReport_;
+}
+
+InputRecorder::Report InputRecorder::Replay(const std::wstring& path)
+{
+	Report report;
+
+	FILE* fp = nullptr;
+	if (_wfopen_s(&fp, path.c_str(), L"rb") != 0)
+	{
+		report.error = L"Could not open " + path;
+		return report;
+	}
+
+	std::vector<InputRecord> records;
+	const bool valid = InputReplay::Load(fp, records);
+	fclose(fp);
+
+	if (!valid)
+	{
+		report.error = path + L" is not an input recording";
+		return report;
+	}
+
+	return Input::i()->Replay(records);
+}
+
+void InputRecorder::DrawMenu()
+{
+	const auto path = ConfigurationFile::i()->folder() + L"input.rec";
+
+	if (recording())
+	{
+		ImGui::Text("%zu messages recorded", recordedCount());
+		ImGui::SameLine();
+		if (ImGui::Button("Stop recording"))
+			Stop();
+	}
+	else
+	{
+		if (ImGui::Button("Start recording"))
+			Start(path);
+		ImGui::SameLine();
+		if (!replaying() && ImGui::Button("Replay"))
+			StartReplay(path);
+	}
+
+	if (replaying())
+		ImGui::TextUnformatted("Replaying; live input goes straight to the game until it is done.");
+
+	const auto report = lastReport();
+	if (!report.error.empty())
+	{
+		ImGui::TextUnformatted(utf8_encode(report.error).c_str());
+		return;
+	}
+	if (report.messages == 0)
+		return;
+
+	ImGui::Text("%zu messages replayed: p50 %.1f us, p99 %.1f us, max %.1f us", report.messages, report.p50, report.p99, report.max);
+	for (size_t i = 0; i < report.histogram.size(); i++)
+	{
+		if (report.histogram[i] == 0)
+			continue;
+		if (i + 1 < report.histogram.size())
+			ImGui::Text("  < %llu us: %zu", 1ull << i, report.histogram[i]);
+		else
+			ImGui::Text("  >= %llu us: %zu", 1ull << (i - 1), report.histogram[i]);
+	}
+
+	ImGui::Text("%zu key events sent, %zu synthetic messages in the recording", report.sentKeys.size(), report.recordedSynthetic);
+	for (const auto& k : report.sentKeys)
+		ImGui::Text("  %llu ms: %s %s", k.time, KeyName(k.vk).c_str(), k.down ? "down" : "up");
+}
+
+}
+
+#endif
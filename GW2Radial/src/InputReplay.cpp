@@ -0,0 +1,134 @@
+#include <InputReplay.h>
+#include <InputScheduler.h>
+#include <Main.h>
+#include <algorithm>
+#include <chrono>
+
+namespace GW2Radial
+{
+
+bool InputReplay::Load(FILE* fp, std::vector<InputRecord>& records)
+{
+	records.clear();
+
+	RecordingHeader header { };
+	if (fread(&header, sizeof(header), 1, fp) != 1 || !std::equal(std::begin(RecordingHeader::Magic), std::end(RecordingHeader::Magic), header.magic) || header.version != RecordingHeader::Version)
+		return false;
+
+	InputRecord r;
+	while (fread(&r, sizeof(r), 1, fp) == 1)
+		records.push_back(r);
+
+	return true;
+}
+
+bool InputReplay::Replayable(uint msg)
+{
+	switch (msg)
+	{
+	case WM_KEYDOWN:
+	case WM_KEYUP:
+	case WM_SYSKEYDOWN:
+	case WM_SYSKEYUP:
+	case WM_LBUTTONDOWN:
+	case WM_LBUTTONUP:
+	case WM_RBUTTONDOWN:
+	case WM_RBUTTONUP:
+	case WM_MBUTTONDOWN:
+	case WM_MBUTTONUP:
+	case WM_XBUTTONDOWN:
+	case WM_XBUTTONUP:
+	case WM_MOUSEMOVE:
+	case WM_KILLFOCUS:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static thread_local InputReplay* runningReplay = nullptr;
+
+InputReplay* InputReplay::running()
+{
+	return runningReplay;
+}
+
+void InputReplay::SendKeybind(const KeyCombo& keys)
+{
+	// Same sequence as Input::SendKeybind, stamped with simulated time
+	InputScheduler::SequenceKeybind(keys - dispatcher_.downKeys(), clock_, [this](uint vk, bool down, int64_t due)
+	{
+		sentKeys_.push_back({ mstime(Clock::Convert(due, clock_.ticksPerSecond(), 1000)), vk, down });
+	});
+}
+
+InputReplay::Report InputReplay::Run(const std::vector<InputRecord>& records, std::mutex* dispatchLock)
+{
+	Report report;
+	sentKeys_.clear();
+	dispatcher_.ClearDownKeys();
+
+	const auto* previousSource = &Clock::source();
+	auto* previousReplay = runningReplay;
+	Clock::source(&clock_);
+	runningReplay = this;
+
+	std::vector<double> latencies;
+	latencies.reserve(records.size());
+
+	for (const auto& r : records)
+	{
+		clock_.microseconds = int64_t(r.time);
+
+		if (r.flags & InputRecord::Synthetic)
+		{
+			report.recordedSynthetic++;
+			continue;
+		}
+
+		if (r.msg == WM_KILLFOCUS)
+		{
+			dispatcher_.ClearDownKeys();
+			continue;
+		}
+
+		// Waiting for the lock is not part of handling the message
+		std::unique_lock<std::mutex> lock;
+		if (dispatchLock)
+			lock = std::unique_lock<std::mutex>(*dispatchLock);
+
+		const auto before = std::chrono::steady_clock::now();
+		// Raw input handles in older recordings are stale, so only window mouse moves count as movement
+		dispatcher_.Dispatch(InputDispatcher::Translate(r.msg, uintptr_t(r.wParam), intptr_t(r.lParam), distinguishLeftRight_), r.msg == WM_MOUSEMOVE);
+		const double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - before).count();
+		if (lock)
+			lock.unlock();
+
+		latencies.push_back(elapsed);
+
+		size_t bucket = 0;
+		while (bucket + 1 < report.histogram.size() && elapsed >= double(1ull << bucket))
+			bucket++;
+		report.histogram[bucket]++;
+	}
+
+	dispatcher_.ClearDownKeys();
+	runningReplay = previousReplay;
+	Clock::source(previousSource);
+
+	report.messages = latencies.size();
+	if (!latencies.empty())
+	{
+		std::sort(latencies.begin(), latencies.end());
+		report.p50 = latencies[latencies.size() / 2];
+		report.p99 = latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)];
+		report.max = latencies.back();
+	}
+
+	report.sentKeys = std::move(sentKeys_);
+	sentKeys_.clear();
+
+	return report;
+}
+
+}
@@ -0,0 +1,121 @@
+#include <InputScheduler.h>
+#include <Main.h>
+#include <array>
+#include <thread>
+
+namespace GW2Radial
+{
+
+InputScheduler::InputScheduler(const ClockSource& clock, Sender sender)
+	: state_(std::make_shared<State>())
+{
+	state_->clock = &clock;
+	state_->sender = std::move(sender);
+
+	std::thread(Run, state_).detach();
+}
+
+InputScheduler::~InputScheduler()
+{
+	{
+		std::lock_guard<std::mutex> lock(state_->mutex);
+		state_->stop = true;
+	}
+	state_->timer.Wake();
+}
+
+void InputScheduler::Schedule(const Message& m)
+{
+	bool earliest;
+	{
+		std::lock_guard<std::mutex> lock(state_->mutex);
+		earliest = state_->pending.empty() || m.due < state_->pending.top().message.due;
+		state_->pending.push({ m, state_->nextSequence++ });
+	}
+
+	// Only a new earliest deadline requires the timer to be rearmed
+	if (earliest)
+		state_->timer.Wake();
+}
+
+void InputScheduler::Clear()
+{
+	std::lock_guard<std::mutex> lock(state_->mutex);
+	state_->pending = { };
+}
+
+void InputScheduler::SequenceKeybind(const KeyCombo& keys, const ClockSource& clock, const KeyStep& step)
+{
+	static const KeyCombo modifiers { VK_CONTROL, VK_LCONTROL, VK_RCONTROL, VK_SHIFT, VK_LSHIFT, VK_RSHIFT, VK_MENU, VK_LMENU, VK_RMENU };
+
+	std::array<uint, KeyCombo::KeyCount> order;
+	size_t count = 0;
+	for (uint vk : keys & modifiers)
+		order[count++] = vk;
+	for (uint vk : keys - modifiers)
+		order[count++] = vk;
+
+	const int64_t start = clock.ticks();
+	const auto at = [&](mstime offset) { return start + Clock::Convert(int64_t(offset), 1000, clock.ticksPerSecond()); };
+
+	mstime offset = 10;
+	for (size_t i = 0; i < count; i++, offset += 20)
+		step(order[i], true, at(offset));
+
+	offset += 50;
+
+	for (size_t i = count; i-- > 0; offset += 20)
+		step(order[i], false, at(offset));
+}
+
+bool InputScheduler::empty() const
+{
+	std::lock_guard<std::mutex> lock(state_->mutex);
+	return state_->pending.empty();
+}
+
+// Rounded up, so a timer firing on time always finds the message due
+static int64_t ToTimerUnits(int64_t ticks, int64_t ticksPerSecond)
+{
+	constexpr int64_t unitsPerSecond = 10000000;
+	const auto units = Clock::Convert(ticks, ticksPerSecond, unitsPerSecond);
+	return Clock::Convert(units, unitsPerSecond, ticksPerSecond) < ticks ? units + 1 : units;
+}
+
+int64_t InputScheduler::SendDue()
+{
+	int64_t delay;
+	SendDue(*state_, delay);
+	return delay;
+}
+
+bool InputScheduler::SendDue(State& state, int64_t& delay)
+{
+	delay = -1;
+
+	// Everything touching the clock or the sender happens under the lock, so neither is used
+	// once the destructor has set stop and they are free to go away
+	std::lock_guard<std::mutex> lock(state.mutex);
+	if (state.stop)
+		return false;
+
+	const auto now = state.clock->ticks();
+	while (!state.pending.empty() && state.pending.top().message.due <= now)
+	{
+		state.sender(state.pending.top().message);
+		state.pending.pop();
+	}
+
+	if (!state.pending.empty())
+		delay = ToTimerUnits(state.pending.top().message.due - now, state.clock->ticksPerSecond());
+	return true;
+}
+
+void InputScheduler::Run(std::shared_ptr<State> state)
+{
+	int64_t delay;
+	while (SendDue(*state, delay))
+		state->timer.Wait(delay);
+}
+
+}
@@ -0,0 +1,136 @@
+#include <InstancedQuad.h>
+#include <UnitQuad.h>
+
+namespace GW2Radial
+{
+
+const D3DVERTEXELEMENT9 InstancedQuadDefinition[6] =
+{
+	{ 0, 0, D3DDECLTYPE_FLOAT2, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_TEXCOORD, 0 },
+	{ 1, offsetof(QuadInstance, spriteDimensions), D3DDECLTYPE_FLOAT4, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_TEXCOORD, 1 },
+	{ 1, offsetof(QuadInstance, uvRect), D3DDECLTYPE_FLOAT4, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_TEXCOORD, 2 },
+	{ 1, offsetof(QuadInstance, color), D3DDECLTYPE_FLOAT4, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_TEXCOORD, 3 },
+	{ 1, offsetof(QuadInstance, params), D3DDECLTYPE_FLOAT4, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_TEXCOORD, 4 },
+	D3DDECL_END()
+};
+
+InstancedQuad::InstancedQuad(IDirect3DDevice9* device, uint capacity)
+	: device_(device), capacity_(capacity)
+{
+	if (!device_ || capacity_ == 0)
+		throw std::exception();
+
+	HRESULT hr = device_->CreateVertexDeclaration(def(), &vertexDeclaration_);
+	if (FAILED(hr))
+		throw std::exception();
+
+	// Rewritten every frame, so dynamic and discarded on each upload
+	hr = device_->CreateVertexBuffer(capacity_ * stride(), D3DUSAGE_DYNAMIC | D3DUSAGE_WRITEONLY, 0, D3DPOOL_DEFAULT, &buffer_, nullptr);
+	if (FAILED(hr))
+		throw std::exception();
+}
+
+InstancedQuad::~InstancedQuad()
+{
+	COM_RELEASE(vertexDeclaration_);
+	COM_RELEASE(buffer_);
+}
+
+const D3DVERTEXELEMENT9 * InstancedQuad::def()
+{
+	return InstancedQuadDefinition;
+}
+
+bool InstancedQuad::Upload(const QuadInstance* instances, uint count)
+{
+	if (!buffer_ || count == 0 || count > capacity_)
+		return false;
+
+	LPVOID ptr = nullptr;
+	if (FAILED(buffer_->Lock(0, count * stride(), &ptr, D3DLOCK_DISCARD)))
+		return false;
+
+	CopyMemory(ptr, instances, count * stride());
+
+	return SUCCEEDED(buffer_->Unlock());
+}
+
+void InstancedQuad::Bind(const UnitQuad& quad) const
+{
+	if (!device_ || !vertexDeclaration_ || !buffer_)
+		return;
+
+	quad.Bind(0);
+	device_->SetVertexDeclaration(vertexDeclaration_);
+	device_->SetStreamSourceFreq(1, D3DSTREAMSOURCE_INSTANCEDATA | 1u);
+}
+
+void InstancedQuad::Draw(uint firstInstance, uint instanceCount) const
+{
+	if (!device_ || instanceCount == 0)
+		return;
+
+	device_->SetStreamSource(1, buffer_, firstInstance * stride(), stride());
+	device_->SetStreamSourceFreq(0, D3DSTREAMSOURCE_INDEXEDDATA | instanceCount);
+	device_->DrawIndexedPrimitive(D3DPT_TRIANGLELIST, 0, 0, 4, 0, 2);
+}
+
+void InstancedQuad::Unbind(const UnitQuad& quad) const
+{
+	if (!device_)
+		return;
+
+	device_->SetStreamSourceFreq(0, 1);
+	device_->SetStreamSourceFreq(1, 1);
+	device_->SetStreamSource(1, nullptr, 0, 0);
+	quad.Bind(0);
+}
+
+void InstancedQuad::DrawAll(Effect* fx, const UnitQuad& quad, InstancedQuad* instances, const QuadInstance* data, IDirect3DTexture9* const* textures, uint count)
+{
+	const bool instanced = instances && fx->instancing() && instances->Upload(data, count);
+
+	uint passes = 0;
+	if (instanced)
+		fx->SetInstanced(true);
+	fx->Begin(&passes, 0);
+	fx->BeginPass(0);
+	if (instanced)
+		instances->Bind(quad);
+
+	for (uint first = 0; first < count;)
+	{
+		auto* texture = textures[first];
+		uint last = first + 1;
+		fx->SetTexture(EFF_TS_ELEMENTIMG, texture);
+
+		if (instanced)
+		{
+			while (last < count && textures[last] == texture)
+				last++;
+			instances->Draw(first, last - first);
+		}
+		else
+		{
+			auto instance = data[first];
+			fx->SetVector(EFF_VS_SPRITE_DIM, &instance.spriteDimensions);
+			fx->SetVector(EFF_VS_ELEMENT_UV_RECT, &instance.uvRect);
+			fx->SetVector(EFF_VS_ELEMENT_COLOR, &instance.color);
+			fx->SetVector(EFF_VS_ELEMENT_PARAMS, &instance.params);
+			fx->CommitChanges();
+			quad.Draw();
+		}
+
+		first = last;
+	}
+
+	if (instanced)
+	{
+		instances->Unbind(quad);
+		fx->SetInstanced(false);
+	}
+	fx->EndPass();
+	fx->End();
+}
+
+}
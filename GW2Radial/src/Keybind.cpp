@@ -1,14 +1,15 @@
 #include <Keybind.h>
+#include <KeybindMatcher.h>
 #include <Utility.h>
-#include <sstream>
 #include <ConfigurationFile.h>
-#include <numeric>
+#include <algorithm>
 
 namespace GW2Radial
 {
-std::unordered_map<Keybind*, std::set<uint>> Keybind::keyMaps_;
+std::unordered_map<KeyCombo, std::vector<Keybind*>, KeyComboHash> Keybind::keybindsByKeys_;
+std::vector<std::vector<KeyCombo>> Keybind::keysBySize_;
 
-Keybind::Keybind(std::string nickname, std::string displayName, const std::set<uint>& keys, bool saveToConfig) :
+Keybind::Keybind(std::string nickname, std::string displayName, const KeyCombo& keys, bool saveToConfig) :
 	nickname_(std::move(nickname)), displayName_(std::move(displayName)), saveToConfig_(saveToConfig)
 {
 	this->keys(keys);
@@ -25,10 +26,10 @@ Keybind::Keybind(std::string nickname, std::string displayName) :
 
 Keybind::~Keybind()
 {
-	keyMaps_.erase(this);
+	Unindex();
 }
 
-void Keybind::keys(const std::set<uint>& keys)
+void Keybind::keys(const KeyCombo& keys)
 {
 	if(!isBeingModified_)
 		return;
@@ -43,21 +44,9 @@ void Keybind::keys(const char * keys)
 	if(!isBeingModified_)
 		return;
 
-	keys_.clear();
-
-	if (strnlen_s(keys, 256) > 0)
-	{
-		std::stringstream ss(keys);
-		std::vector<std::string> result;
-
-		while (ss.good())
-		{
-			std::string substr;
-			std::getline(ss, substr, ',');
-			const auto val = std::stoi(substr);
-			keys_.insert(static_cast<uint>(val));
-		}
-	}
+	// A malformed entry only loses that key, rather than the whole keybind or the startup
+	if(const auto error = KeyCombo::Parse(keys, keys_); error != std::string_view::npos)
+		FormattedOutputDebugString("Keybind '%s' has an invalid key at offset %zu, skipping it\n", nickname_.c_str(), error);
 
 	ApplyKeys();
 }
@@ -66,81 +55,136 @@ void Keybind::ApplyKeys()
 {
 	UpdateDisplayString();
 
-	CheckForConflict();
+	Unindex();
+	Index();
 	
 	if(saveToConfig_)
 	{
-		std::string settingValue;
-		for (const auto& k : keys_)
-			settingValue += std::to_string(k) + ", ";
-
-		if(!keys_.empty())
-			settingValue = settingValue.substr(0, settingValue.size() - 2);
+		KeyCombo::SerializedBuffer settingValue;
+		keys_.Serialize(settingValue);
 
 		auto cfg = ConfigurationFile::i();
-		cfg->ini().SetValue("keybinds", nickname_.c_str(), settingValue.c_str());
+		cfg->ini().SetValue("keybinds", nickname_.c_str(), settingValue.data());
 		cfg->Save();
 	}
 }
 
-void Keybind::CheckForConflict(bool recurse)
+void Keybind::Unindex()
 {
-	keyMaps_[this] = keys_;
-	
 	isConflicted_ = false;
-	for(auto& elem : keyMaps_)
+	if(indexedKeys_.empty())
+		return;
+
+	const auto group = keybindsByKeys_.find(indexedKeys_);
+	auto& members = group->second;
+	members.erase(std::find(members.begin(), members.end(), this));
+
+	if(members.size() == 1)
+		members.front()->isConflicted_ = false;
+	else if(members.empty())
+	{
+		auto& sameSize = keysBySize_[indexedKeys_.size()];
+		sameSize.erase(std::find(sameSize.begin(), sameSize.end(), indexedKeys_));
+		keybindsByKeys_.erase(group);
+	}
+
+	indexedKeys_.clear();
+	KeybindMatcher::Invalidate();
+}
+
+void Keybind::Index()
+{
+	if(keys_.empty())
+		return;
+
+	auto& members = keybindsByKeys_[keys_];
+	if(members.empty())
 	{
-		if(elem.first != this && !keys_.empty() && elem.second == keys_)
-			isConflicted_ = true;
-		
-		if(recurse) elem.first->CheckForConflict(false);
+		const auto size = keys_.size();
+		if(keysBySize_.size() <= size)
+			keysBySize_.resize(size + 1);
+		keysBySize_[size].push_back(keys_);
 	}
+
+	members.push_back(this);
+	if(members.size() > 1)
+	{
+		for(auto* kb : members)
+			kb->isConflicted_ = true;
+	}
+
+	indexedKeys_ = keys_;
+	KeybindMatcher::Invalidate();
 }
 
-bool Keybind::conflicts(const std::set<uint>& pressedKeys) const
+bool Keybind::conflicts(const KeyCombo& pressedKeys) const
 {
-	for(auto& elem : keyMaps_)
+	// Only keybinds longer than this one, but no longer than what is held, can be held down and shadow it
+	const auto pressedCount = std::min(pressedKeys.size(), keysBySize_.empty() ? 0 : keysBySize_.size() - 1);
+	for(size_t n = keys_.size() + 1; n <= pressedCount; n++)
 	{
-		if(elem.first != this && keys_.size() < elem.second.size()
-			&& std::includes(pressedKeys.begin(), pressedKeys.end(), elem.second.begin(), elem.second.end()))
-			return true;
+		for(const auto& k : keysBySize_[n])
+		{
+			if(pressedKeys.includes(k))
+				return true;
+		}
 	}
 
 	return false;
 }
 
-bool Keybind::matchesNoLeftRight(const std::set<uint>& pressedKeys) const
+bool Keybind::matchesNoLeftRight(const KeyCombo& pressedKeys) const
 {
+	static const std::array<std::pair<KeyCombo, uint>, 3> sides {{
+		{ { VK_LCONTROL, VK_RCONTROL }, VK_CONTROL },
+		{ { VK_LSHIFT, VK_RSHIFT }, VK_SHIFT },
+		{ { VK_LMENU, VK_RMENU }, VK_MENU }
+	}};
+
 	auto k2 = pressedKeys;
-	const auto rep = [&](uint vk, uint vkr)
+	for(const auto& [sided, generic] : sides)
 	{
-		if(const auto k = k2.find(vk); k != k2.end())
+		if(k2.intersects(sided))
 		{
-			k2.erase(k);
-			k2.insert(vkr);
+			k2 -= sided;
+			k2.insert(generic);
 		}
-	};
-	rep(VK_LCONTROL, VK_CONTROL);
-	rep(VK_RCONTROL, VK_CONTROL);
-	rep(VK_LSHIFT, VK_SHIFT);
-	rep(VK_RSHIFT, VK_SHIFT);
-	rep(VK_LMENU, VK_MENU);
-	rep(VK_RMENU, VK_MENU);
+	}
 
 	return k2 == keys_;
 }
 
 void Keybind::UpdateDisplayString()
 {
-	if(keys_.empty())
+	// Formatted in place from the key name table; keys which no longer fit are left out rather than cut in half
+	static constexpr char separator[] = " + ";
+	static constexpr size_t separatorLength = sizeof(separator) - 1;
+
+	const auto names = KeyNames();
+	char* out = keysDisplayString_.data();
+	char* const end = out + keysDisplayString_.size() - 1;
+	for(auto k : keys_)
 	{
-		keysDisplayString_[0] = '\0';
-		return;
+		const auto& name = (*names)[k];
+		const bool first = out == keysDisplayString_.data();
+		if(size_t(end - out) < name.size() + (first ? 0 : separatorLength))
+			break;
+
+		if(!first)
+			out = std::copy_n(separator, separatorLength, out);
+		out = std::copy_n(name.data(), name.size(), out);
 	}
 
-	std::wstring keybind = std::accumulate(std::next(keys_.begin()), keys_.end(), GetKeyName(*keys_.begin()), [](std::wstring a, uint b) { return std::move(a) + L" + " + GetKeyName(b); });
+	*out = '\0';
+}
 
-	strcpy_s(keysDisplayString_.data(), keysDisplayString_.size(), utf8_encode(keybind).c_str());
+void Keybind::UpdateDisplayStrings()
+{
+	for(auto& group : keybindsByKeys_)
+	{
+		for(auto* kb : group.second)
+			kb->UpdateDisplayString();
+	}
 }
 
 }
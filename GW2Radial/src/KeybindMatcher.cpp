@@ -0,0 +1,59 @@
+#include <KeybindMatcher.h>
+#include <algorithm>
+
+namespace GW2Radial
+{
+
+std::vector<KeybindMatcher::Chord> KeybindMatcher::chords_;
+std::vector<size_t> KeybindMatcher::firstOfSize_;
+std::atomic<bool> KeybindMatcher::dirty_ { true };
+KeyCombo KeybindMatcher::lastPressed_;
+const KeybindMatcher::Chord* KeybindMatcher::lastMatch_ = nullptr;
+
+size_t KeybindMatcher::longestHeld(const KeyCombo& pressedKeys)
+{
+	Match(pressedKeys);
+	return lastMatch_ ? lastMatch_->size : 0;
+}
+
+void KeybindMatcher::Rebuild()
+{
+	chords_.clear();
+	for(const auto& group : Keybind::keybindsByKeys_)
+		chords_.push_back({ group.first, group.first.size() });
+
+	std::sort(chords_.begin(), chords_.end(), [](const Chord& a, const Chord& b)
+	{
+		if(a.size != b.size)
+			return a.size > b.size;
+		return std::lexicographical_compare(a.keys.begin(), a.keys.end(), b.keys.begin(), b.keys.end());
+	});
+
+	const size_t longest = chords_.empty() ? 0 : chords_.front().size;
+	firstOfSize_.resize(longest + 1);
+	for(size_t n = 0; n <= longest; n++)
+		firstOfSize_[n] = std::partition_point(chords_.begin(), chords_.end(), [n](const Chord& c) { return c.size > n; }) - chords_.begin();
+}
+
+void KeybindMatcher::Match(const KeyCombo& pressedKeys)
+{
+	if(dirty_.exchange(false, std::memory_order_acquire))
+		Rebuild();
+	else if(pressedKeys == lastPressed_)
+		return;
+
+	lastPressed_ = pressedKeys;
+	lastMatch_ = nullptr;
+
+	const auto pressedCount = std::min(pressedKeys.size(), firstOfSize_.size() - 1);
+	for(size_t i = firstOfSize_[pressedCount]; i < chords_.size(); i++)
+	{
+		if(pressedKeys.includes(chords_[i].keys))
+		{
+			lastMatch_ = &chords_[i];
+			return;
+		}
+	}
+}
+
+}
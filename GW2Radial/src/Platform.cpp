@@ -0,0 +1,38 @@
+#include <Platform.h>
+#include <Clock.h>
+#include <memory>
+
+namespace GW2Radial
+{
+
+// The parts of Platform.h built on top of the OS specific ones, which live in Utility.cpp or Platform_posix.cpp
+
+// Replaced whole on refresh, never modified once published, so readers need no lock
+static std::shared_ptr<const KeyNameTable> currentKeyNames = std::make_shared<const KeyNameTable>();
+
+void RefreshKeyNames()
+{
+	auto table = std::make_shared<KeyNameTable>();
+	for (uint vk = 0; vk < table->size(); vk++)
+		(*table)[vk] = utf8_encode(GetKeyName(vk));
+
+	std::atomic_store_explicit(&currentKeyNames, std::shared_ptr<const KeyNameTable>(std::move(table)), std::memory_order_release);
+}
+
+std::shared_ptr<const KeyNameTable> KeyNames()
+{
+	return std::atomic_load_explicit(&currentKeyNames, std::memory_order_acquire);
+}
+
+std::string KeyName(unsigned int virtualKey)
+{
+	const auto table = KeyNames();
+	return virtualKey < table->size() ? (*table)[virtualKey] : std::string();
+}
+
+mstime TimeInMilliseconds()
+{
+	return Clock::milliseconds();
+}
+
+}
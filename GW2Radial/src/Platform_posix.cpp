@@ -0,0 +1,134 @@
+#include <Platform.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <time.h>
+
+namespace GW2Radial
+{
+
+// Stand-ins for the Win32 half of Platform.h (see Utility.cpp), so the platform independent code
+// can be built and tested on Linux. wchar_t holds whole code points here rather than UTF16 units.
+
+std::string utf8_encode(const std::wstring &wstr)
+{
+	std::string out;
+	out.reserve(wstr.size());
+	for (const wchar_t wc : wstr)
+	{
+		auto c = uint32_t(wc);
+		if (c > 0x10FFFF || (c >= 0xD800 && c < 0xE000))
+			c = 0xFFFD;
+
+		if (c < 0x80)
+			out += char(c);
+		else if (c < 0x800)
+		{
+			out += char(0xC0 | (c >> 6));
+			out += char(0x80 | (c & 0x3F));
+		}
+		else if (c < 0x10000)
+		{
+			out += char(0xE0 | (c >> 12));
+			out += char(0x80 | ((c >> 6) & 0x3F));
+			out += char(0x80 | (c & 0x3F));
+		}
+		else
+		{
+			out += char(0xF0 | (c >> 18));
+			out += char(0x80 | ((c >> 12) & 0x3F));
+			out += char(0x80 | ((c >> 6) & 0x3F));
+			out += char(0x80 | (c & 0x3F));
+		}
+	}
+	return out;
+}
+
+std::wstring utf8_decode(const std::string &str)
+{
+	std::wstring out;
+	out.reserve(str.size());
+	for (size_t i = 0; i < str.size();)
+	{
+		const auto lead = uchar(str[i]);
+		const size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+
+		// Like MultiByteToWideChar, a malformed sequence becomes one replacement character per byte
+		uint32_t c = length == 1 ? lead : length == 2 ? lead & 0x1F : length == 3 ? lead & 0x0F : lead & 0x07;
+		bool valid = length != 0 && i + length <= str.size();
+		for (size_t k = 1; valid && k < length; k++)
+		{
+			const auto cont = uchar(str[i + k]);
+			valid = (cont & 0xC0) == 0x80;
+			c = (c << 6) | (cont & 0x3F);
+		}
+
+		if (!valid)
+		{
+			out += wchar_t(0xFFFD);
+			i++;
+			continue;
+		}
+
+		out += wchar_t(c);
+		i += length;
+	}
+	return out;
+}
+
+std::wstring GetKeyName(unsigned int virtualKey)
+{
+	// Without a keyboard layout to ask, only keys whose virtual key code is their character can be named
+	if ((virtualKey >= '0' && virtualKey <= '9') || (virtualKey >= 'A' && virtualKey <= 'Z'))
+		return std::wstring(1, wchar_t(virtualKey));
+
+	return L"[" + std::to_wstring(virtualKey) + L"]";
+}
+
+int64_t QueryCounter()
+{
+	timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return int64_t(t.tv_sec) * 1000000000 + t.tv_nsec;
+}
+
+int64_t QueryCounterFrequency()
+{
+	return 1000000000;
+}
+
+struct WaitableTimer::State
+{
+	std::mutex mutex;
+	std::condition_variable cv;
+	bool woken = false;
+};
+
+WaitableTimer::WaitableTimer()
+	: state_(std::make_unique<State>())
+{
+}
+
+WaitableTimer::~WaitableTimer() = default;
+
+void WaitableTimer::Wait(int64_t delay)
+{
+	std::unique_lock<std::mutex> lock(state_->mutex);
+	const auto woken = [this] { return state_->woken; };
+	if (delay < 0)
+		state_->cv.wait(lock, woken);
+	else
+		state_->cv.wait_for(lock, std::chrono::nanoseconds(delay * 100), woken);
+	state_->woken = false;
+}
+
+void WaitableTimer::Wake()
+{
+	{
+		std::lock_guard<std::mutex> lock(state_->mutex);
+		state_->woken = true;
+	}
+	state_->cv.notify_one();
+}
+
+}
@@ -0,0 +1,219 @@
+#include <Profiler.h>
+
+#ifdef GW2RADIAL_PROFILER
+
+#include <ConfigurationFile.h>
+#include <Utility.h>
+#include <imgui.h>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+namespace GW2Radial
+{
+
+struct Profiler::Registry
+{
+	std::mutex mutex;
+	std::vector<std::unique_ptr<ThreadEvents>> threads;
+};
+
+// Statistics cover this much of the most recent history and are recomputed at this rate
+constexpr int64_t StatsWindowSeconds = 5;
+constexpr mstime StatsUpdateInterval = 500;
+
+static int64_t TicksPerSecond()
+{
+	static const int64_t frequency = []()
+	{
+		int64_t f;
+		QueryPerformanceFrequency(reinterpret_cast<LARGE_INTEGER*>(&f));
+		return f;
+	}();
+	return frequency;
+}
+
+Profiler::Registry& Profiler::registry()
+{
+	// Leaked on purpose, threads still running at unload must never see it destroyed
+	static Registry* r = new Registry;
+	return *r;
+}
+
+Profiler::ThreadEvents& Profiler::LocalEvents()
+{
+	thread_local ThreadEvents* local = nullptr;
+	if (!local)
+	{
+		auto& r = registry();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		r.threads.push_back(std::make_unique<ThreadEvents>());
+		local = r.threads.back().get();
+		local->threadId = GetCurrentThreadId();
+	}
+	return *local;
+}
+
+void Profiler::Record(const Event& e)
+{
+	auto& t = LocalEvents();
+	const auto w = t.written.load(std::memory_order_relaxed);
+	auto& slot = t.events[w % EventsPerThread];
+
+	slot.sequence.store(2 * w + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	slot.zone.store(e.zone, std::memory_order_relaxed);
+	slot.start.store(e.start, std::memory_order_relaxed);
+	slot.end.store(e.end, std::memory_order_relaxed);
+	slot.sequence.store(2 * w + 2, std::memory_order_release);
+
+	t.written.store(w + 1, std::memory_order_release);
+}
+
+std::vector<Profiler::ThreadEvent> Profiler::Snapshot()
+{
+	std::vector<ThreadEvent> out;
+
+	auto& r = registry();
+	std::lock_guard<std::mutex> lock(r.mutex);
+	for (const auto& t : r.threads)
+	{
+		const size_t end = t->written.load(std::memory_order_acquire);
+		const size_t begin = end > EventsPerThread ? end - EventsPerThread : 0;
+		for (size_t i = begin; i < end; i++)
+		{
+			const auto& slot = t->events[i % EventsPerThread];
+			const size_t complete = 2 * i + 2;
+			if (slot.sequence.load(std::memory_order_acquire) != complete)
+				continue;
+
+			const Event e { slot.zone.load(std::memory_order_relaxed), slot.start.load(std::memory_order_relaxed), slot.end.load(std::memory_order_relaxed) };
+
+			// Overwritten while it was read, by an event recorded since end was loaded
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (slot.sequence.load(std::memory_order_relaxed) != complete)
+				continue;
+
+			out.push_back({ t->threadId, e });
+		}
+	}
+
+	return out;
+}
+
+void Profiler::DrawOverlay()
+{
+	struct ZoneStats
+	{
+		const char* zone;
+		size_t count;
+		double p50, p99, max;
+	};
+	static std::vector<ZoneStats> stats;
+	static mstime lastUpdate = 0;
+	static std::string dumpResult;
+
+	const auto now = TimeInMilliseconds();
+	if (now - lastUpdate >= StatsUpdateInterval)
+	{
+		lastUpdate = now;
+
+		int64_t nowTicks;
+		QueryPerformanceCounter(reinterpret_cast<LARGE_INTEGER*>(&nowTicks));
+		const int64_t windowTicks = StatsWindowSeconds * TicksPerSecond();
+		const double msPerTick = 1000.0 / TicksPerSecond();
+
+		std::unordered_map<const char*, std::vector<double>> durations;
+		for (const auto& te : Snapshot())
+		{
+			if (nowTicks - te.event.end <= windowTicks)
+				durations[te.event.zone].push_back((te.event.end - te.event.start) * msPerTick);
+		}
+
+		// Nearest-rank percentiles
+		const auto percentile = [](const std::vector<double>& sorted, size_t p) { return sorted[(sorted.size() * p + 99) / 100 - 1]; };
+
+		stats.clear();
+		for (auto& [zone, d] : durations)
+		{
+			std::sort(d.begin(), d.end());
+			stats.push_back({ zone, d.size(), percentile(d, 50), percentile(d, 99), d.back() });
+		}
+		std::sort(stats.begin(), stats.end(), [](const ZoneStats& a, const ZoneStats& b) { return strcmp(a.zone, b.zone) < 0; });
+	}
+
+	ImGui::Begin("Profiler");
+
+	ImGui::Text("Last %lld seconds", StatsWindowSeconds);
+	ImGui::Columns(5, "zones");
+	ImGui::TextUnformatted("Zone"); ImGui::NextColumn();
+	ImGui::TextUnformatted("Count"); ImGui::NextColumn();
+	ImGui::TextUnformatted("p50 (ms)"); ImGui::NextColumn();
+	ImGui::TextUnformatted("p99 (ms)"); ImGui::NextColumn();
+	ImGui::TextUnformatted("Max (ms)"); ImGui::NextColumn();
+	ImGui::Separator();
+	for (const auto& s : stats)
+	{
+		ImGui::TextUnformatted(s.zone); ImGui::NextColumn();
+		ImGui::Text("%zu", s.count); ImGui::NextColumn();
+		ImGui::Text("%.3f", s.p50); ImGui::NextColumn();
+		ImGui::Text("%.3f", s.p99); ImGui::NextColumn();
+		ImGui::Text("%.3f", s.max); ImGui::NextColumn();
+	}
+	ImGui::Columns(1);
+
+	if (ImGui::Button("Dump trace"))
+	{
+		const auto path = ConfigurationFile::i()->folder() + L"trace.json";
+		dumpResult = DumpTrace(path) ? "Saved to " + utf8_encode(path) : "Could not write " + utf8_encode(path);
+	}
+	if (!dumpResult.empty())
+		ImGui::TextUnformatted(dumpResult.c_str());
+
+	ImGui::End();
+}
+
+bool Profiler::DumpTrace(const std::wstring& path)
+{
+	using json = nlohmann::json;
+
+	const auto events = Snapshot();
+	if (events.empty())
+		return false;
+
+	int64_t origin = events.front().event.start;
+	for (const auto& te : events)
+		origin = std::min(origin, te.event.start);
+
+	const double usPerTick = 1000000.0 / TicksPerSecond();
+	const auto pid = GetCurrentProcessId();
+
+	json traceEvents = json::array();
+	for (const auto& te : events)
+	{
+		traceEvents.push_back({
+			{ "name", te.event.zone },
+			{ "ph", "X" },
+			{ "ts", (te.event.start - origin) * usPerTick },
+			{ "dur", (te.event.end - te.event.start) * usPerTick },
+			{ "pid", pid },
+			{ "tid", te.threadId }
+		});
+	}
+
+	const auto contents = json { { "traceEvents", traceEvents }, { "displayTimeUnit", "ms" } }.dump();
+
+	FILE *fp = nullptr;
+	if (_wfopen_s(&fp, path.c_str(), L"wb") != 0)
+		return false;
+
+	const bool written = fwrite(contents.data(), 1, contents.size(), fp) == contents.size();
+	fclose(fp);
+
+	return written;
+}
+
+}
+
+#endif
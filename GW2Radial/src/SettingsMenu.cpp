@@ -10,7 +10,7 @@ DEFINE_SINGLETON(SettingsMenu);
 SettingsMenu::SettingsMenu()
 	: showKeybind_("show_settings", "Show settings", { VK_SHIFT, VK_MENU, 'M' }, false)
 {
-	inputChangeCallback_ = [this](bool changed, const std::set<uint>& keys, const std::list<EventKey>& changedKeys) { return OnInputChange(changed, keys, changedKeys); };
+	inputChangeCallback_ = [this](bool changed, const KeyCombo& keys, const EventKeys& changedKeys) { return OnInputChange(changed, keys, changedKeys); };
 	Input::i()->AddInputChangeCallback(&inputChangeCallback_);
 }
 void SettingsMenu::Draw()
@@ -74,7 +74,7 @@ void SettingsMenu::Draw()
 	}
 }
 
-InputResponse SettingsMenu::OnInputChange(bool /*changed*/, const std::set<uint>& keys, const std::list<EventKey>& /*changedKeys*/)
+InputResponse SettingsMenu::OnInputChange(bool /*changed*/, const KeyCombo& keys, const EventKeys& /*changedKeys*/)
 {
 	const bool isMenuKeybind = showKeybind_.matchesNoLeftRight(keys);
 	if(isMenuKeybind)
@@ -0,0 +1,137 @@
+#include <TextureAtlas.h>
+#include <algorithm>
+#include <cstring>
+
+namespace GW2Radial
+{
+
+IDirect3DTexture9* TextureAtlas::Create(IDirect3DDevice9* dev, const std::vector<IDirect3DTexture9*>& sources, std::vector<fVector4>& uvRects)
+{
+	uvRects.clear();
+	if (!dev || sources.empty())
+		return nullptr;
+
+	std::vector<AtlasPacker::Image> images;
+	uint maxLevels = ~0u;
+	D3DFORMAT format = D3DFMT_UNKNOWN;
+	for (auto* src : sources)
+	{
+		// Default pool textures cannot be read back
+		D3DSURFACE_DESC desc;
+		if (!src || FAILED(src->GetLevelDesc(0, &desc)) || desc.Pool == D3DPOOL_DEFAULT)
+			return nullptr;
+		if (format != D3DFMT_UNKNOWN && desc.Format != format)
+			return nullptr;
+
+		format = desc.Format;
+		images.push_back({ desc.Width, desc.Height });
+		maxLevels = std::min(maxLevels, uint(src->GetLevelCount()));
+	}
+
+	AtlasPacker::Format info;
+	if (!FormatInfo(format, info))
+		return nullptr;
+
+	D3DCAPS9 caps;
+	if (FAILED(dev->GetDeviceCaps(&caps)))
+		return nullptr;
+
+	AtlasPacker::Layout layout;
+	if (!AtlasPacker::Pack(images, info.blockSize, maxLevels, MaxBorder, std::min(caps.MaxTextureWidth, caps.MaxTextureHeight), (caps.TextureCaps & D3DPTEXTURECAPS_POW2) != 0, layout))
+		return nullptr;
+
+	IDirect3DTexture9* atlas = nullptr;
+	if (FAILED(dev->CreateTexture(layout.width, layout.height, layout.levels, 0, format, D3DPOOL_MANAGED, &atlas, nullptr)))
+		return nullptr;
+
+	// Positions and borders are multiples of the cell size, so on every level each source lands on whole blocks
+	for (uint level = 0; level < layout.levels; level++)
+	{
+		D3DLOCKED_RECT dst;
+		if (FAILED(atlas->LockRect(level, &dst, nullptr, 0)))
+		{
+			atlas->Release();
+			return nullptr;
+		}
+
+		// Only the images and their borders are ever sampled, the space left between them is cleared so it is not garbage
+		const uint levelRows = (layout.height >> level) / info.blockSize;
+		const uint levelRowBytes = (layout.width >> level) / info.blockSize * info.bytesPerBlock;
+		for (uint r = 0; r < levelRows; r++)
+			memset(static_cast<BYTE*>(dst.pBits) + r * dst.Pitch, 0, levelRowBytes);
+
+		bool copied = true;
+		for (size_t i = 0; i < sources.size(); i++)
+		{
+			D3DLOCKED_RECT src;
+			if (FAILED(sources[i]->LockRect(level, &src, nullptr, D3DLOCK_READONLY)))
+			{
+				copied = false;
+				break;
+			}
+
+			AtlasPacker::CopyLevel(layout, images[i], layout.positions[i], level, info,
+			                       static_cast<const BYTE*>(src.pBits), src.Pitch, static_cast<BYTE*>(dst.pBits), dst.Pitch);
+
+			sources[i]->UnlockRect(level);
+		}
+
+		atlas->UnlockRect(level);
+		if (!copied)
+		{
+			atlas->Release();
+			return nullptr;
+		}
+	}
+
+	const float w = float(layout.width), h = float(layout.height);
+	for (size_t i = 0; i < images.size(); i++)
+	{
+		const auto& pos = layout.positions[i];
+		uvRects.push_back({ pos.x / w, pos.y / h, (pos.x + images[i].width) / w, (pos.y + images[i].height) / h });
+	}
+
+	return atlas;
+}
+
+bool TextureAtlas::FormatInfo(D3DFORMAT format, AtlasPacker::Format& info)
+{
+	info = { AtlasPacker::Encoding::Texels, 1, 0 };
+	switch (format)
+	{
+	case D3DFMT_DXT1:
+		info = { AtlasPacker::Encoding::DXT1, 4, 8 };
+		return true;
+	// Premultiplied alpha only changes how the colors are meant, not how they are stored
+	case D3DFMT_DXT2:
+	case D3DFMT_DXT3:
+		info = { AtlasPacker::Encoding::DXT3, 4, 16 };
+		return true;
+	case D3DFMT_DXT4:
+	case D3DFMT_DXT5:
+		info = { AtlasPacker::Encoding::DXT5, 4, 16 };
+		return true;
+	case D3DFMT_L8:
+	case D3DFMT_A8:
+		info.bytesPerBlock = 1;
+		return true;
+	case D3DFMT_A8L8:
+	case D3DFMT_L16:
+	case D3DFMT_R5G6B5:
+	case D3DFMT_X1R5G5B5:
+	case D3DFMT_A1R5G5B5:
+	case D3DFMT_A4R4G4B4:
+		info.bytesPerBlock = 2;
+		return true;
+	case D3DFMT_A8R8G8B8:
+	case D3DFMT_X8R8G8B8:
+	case D3DFMT_A8B8G8R8:
+	case D3DFMT_X8B8G8R8:
+		info.bytesPerBlock = 4;
+		return true;
+	default:
+		return false;
+	}
+}
+
+}
@@ -3,6 +3,7 @@
 #include <d3d9types.h>
 #include <Core.h>
 #include <winuser.h>
+#include <iterator>
 #include "DDSTextureLoader.h"
 
 namespace GW2Radial
@@ -92,7 +93,7 @@ std::wstring GetKeyName(unsigned int virtualKey)
 	}
 
 	wchar_t keyName[50];
-	if (GetKeyNameTextW(scanCode << 16, keyName, sizeof(keyName)) != 0)
+	if (GetKeyNameTextW(scanCode << 16, keyName, int(std::size(keyName))) != 0)
 		return keyName;
 	
 	return L"[Error]";
@@ -105,13 +106,74 @@ void SplitFilename(const tstring& str, tstring* folder, tstring* file)
 	if (file) *file = str.substr(found + 1);
 }
 
-mstime TimeInMilliseconds()
+int64_t QueryCounter()
 {
-	mstime iCount;
-	QueryPerformanceCounter(reinterpret_cast<LARGE_INTEGER*>(&iCount));
-	mstime iFreq;
-	QueryPerformanceFrequency(reinterpret_cast<LARGE_INTEGER*>(&iFreq));
-	return 1000 * iCount / iFreq;
+	LARGE_INTEGER t;
+	QueryPerformanceCounter(&t);
+	return t.QuadPart;
+}
+
+int64_t QueryCounterFrequency()
+{
+	LARGE_INTEGER f;
+	QueryPerformanceFrequency(&f);
+	return f.QuadPart;
+}
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+struct WaitableTimer::State
+{
+	HANDLE timer = nullptr;
+	HANDLE wake = nullptr;
+};
+
+WaitableTimer::WaitableTimer()
+	: state_(std::make_unique<State>())
+{
+	// High resolution timers need Windows 10 1803, older systems get the regular, coarser kind
+	state_->timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+	if (!state_->timer)
+		state_->timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+	state_->wake = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+}
+
+WaitableTimer::~WaitableTimer()
+{
+	if (state_->timer)
+		CloseHandle(state_->timer);
+	if (state_->wake)
+		CloseHandle(state_->wake);
+}
+
+void WaitableTimer::Wait(int64_t delay)
+{
+	if (delay < 0)
+	{
+		WaitForSingleObject(state_->wake, INFINITE);
+		return;
+	}
+
+	if (!state_->timer)
+	{
+		WaitForSingleObject(state_->wake, DWORD((delay + 9999) / 10000));
+		return;
+	}
+
+	// Negative due times are relative
+	LARGE_INTEGER dueTime;
+	dueTime.QuadPart = -LONGLONG(delay);
+	SetWaitableTimer(state_->timer, &dueTime, 0, nullptr, nullptr, FALSE);
+
+	const HANDLE handles[] = { state_->wake, state_->timer };
+	WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+}
+
+void WaitableTimer::Wake()
+{
+	SetEvent(state_->wake);
 }
 
 bool FileExists(const TCHAR* path)
@@ -3,16 +3,24 @@
 #include <Core.h>
 #include <Utility.h>
 #include <UnitQuad.h>
+#include <InstancedQuad.h>
+#include <TextureAtlas.h>
 #include <ImGuiExtensions.h>
 #include <imgui.h>
 #include <utility>
 #include <Input.h>
+#include <KeybindMatcher.h>
 #include "../imgui/imgui_internal.h"
 #include <algorithm>
+#include <Profiler.h>
+#include <Clock.h>
+#include <MumbleLink.h>
 
 namespace GW2Radial
 {
 
+std::vector<Wheel*> Wheel::liveWheels_;
+
 Wheel::Wheel(uint bgResourceId, uint inkResourceId, std::string nickname, std::string displayName, IDirect3DDevice9 * dev)
 	: nickname_(std::move(nickname)), displayName_(std::move(displayName)),
 	  keybind_(nickname_, "Show on mouse"), centralKeybind_(nickname_ + "_cl", "Show in center"),
@@ -34,10 +42,11 @@ Wheel::Wheel(uint bgResourceId, uint inkResourceId, std::string nickname, std::s
 	
 	mouseMoveCallback_ = [this]() { return OnMouseMove(); };
 	Input::i()->AddMouseMoveCallback(&mouseMoveCallback_);
-	inputChangeCallback_ = [this](bool changed, const std::set<uint>& keys, const std::list<EventKey>& changedKeys) { return OnInputChange(changed, keys, changedKeys); };
+	inputChangeCallback_ = [this](bool changed, const KeyCombo& keys, const EventKeys& changedKeys) { return OnInputChange(changed, keys, changedKeys); };
 	Input::i()->AddInputChangeCallback(&inputChangeCallback_);
 
 	SettingsMenu::i()->AddImplementer(this);
+	liveWheels_.push_back(this);
 }
 
 Wheel::~Wheel()
@@ -53,6 +62,14 @@ Wheel::~Wheel()
 	
 	if(auto i = SettingsMenu::iNoInit(); i)
 		i->RemoveImplementer(this);
+
+	liveWheels_.erase(std::remove(liveWheels_.begin(), liveWheels_.end(), this), liveWheels_.end());
+}
+
+void Wheel::OnDeviceUnset()
+{
+	for(auto* wheel : liveWheels_)
+		wheel->instances_.reset();
 }
 
 void Wheel::UpdateHover()
@@ -69,22 +86,15 @@ void Wheel::UpdateHover()
 
 	WheelElement* lastHovered = currentHovered_;
 
-	auto activeElements = GetActiveElements();
+	// Runs on the input thread, so it takes whatever the last frame published rather than rebuilding
+	const auto active = std::atomic_load_explicit(&activeElements_, std::memory_order_acquire);
+	const auto& activeElements = active->elements;
 
 	float mpLenSq = mousePos.x * mousePos.x + mousePos.y * mousePos.y;
 
 	// Middle circle does not count as a hover event
 	if (!activeElements.empty() && mpLenSq > SQUARE(scaleOption_.value() * 0.125f * 0.8f * centerScaleOption_.value()))
-	{
-		float mouseAngle = atan2(-mousePos.y, -mousePos.x) - 0.5f * float(M_PI);
-		if (mouseAngle < 0)
-			mouseAngle += float(2 * M_PI);
-
-		const float elementAngle = float(2 * M_PI) / activeElements.size();
-		const int elementId = int((mouseAngle - elementAngle / 2) / elementAngle + 1) % activeElements.size();
-
-		currentHovered_ = activeElements[elementId];
-	}
+		currentHovered_ = activeElements[active->layout.HoveredSector({ -mousePos.x, -mousePos.y })];
 	else
 		currentHovered_ = GetCenterHoveredElement();
 
@@ -104,8 +114,14 @@ void Wheel::DrawMenu()
 
 	ImGui::TextUnformatted("Set the following to your in-game keybinds:");
 
+	// Clearing a keybind here hides its element without going through OnInputChange
 	for(auto& we : wheelElements_)
+	{
+		const bool wasActive = we->isActive();
 		ImGuiKeybindInput(we->keybind());
+		if(we->isActive() != wasActive)
+			activeElementsDirty_ = true;
+	}
 	
 	ImGui::Separator();
 	ImGuiSpacing();
@@ -207,7 +223,12 @@ void Wheel::DrawMenu()
 	{
 		const auto extremum = it == wheelElements_.begin() ? 1 : it == std::prev(wheelElements_.end()) ? -1 : 0;
 		auto& e = *it;
-		if(const auto dir = e->DrawPriority(extremum); dir != 0)
+		const bool wasActive = e->isActive();
+		const auto dir = e->DrawPriority(extremum);
+		if(e->isActive() != wasActive)
+			activeElementsDirty_ = true;
+
+		if(dir != 0)
 		{
 			if(dir == 1 && e == wheelElements_.front() ||
 				dir == -1 && e == wheelElements_.back())
@@ -218,6 +239,7 @@ void Wheel::DrawMenu()
 			const auto tempPriority = eOther->sortingPriority();
 			eOther->sortingPriority(e->sortingPriority());
 			e->sortingPriority(tempPriority);
+			activeElementsDirty_ = true;
 		}
 	}
 
@@ -227,12 +249,15 @@ void Wheel::DrawMenu()
 
 void Wheel::Draw(IDirect3DDevice9* dev, Effect* fx, UnitQuad* quad)
 {
+	PROFILE_SCOPE("Wheel::Draw");
+
 	if (isVisible_)
 	{
 		const int screenWidth = Core::i()->screenWidth();
 		const int screenHeight = Core::i()->screenHeight();
 
-		const auto currentTime = TimeInMilliseconds();
+		// Everything this frame animates from the same instant
+		const auto currentTime = Clock::frameMilliseconds();
 
 		if (currentTime >= currentTriggerTime_ + displayDelayOption_.value())
 		{
@@ -266,7 +291,8 @@ void Wheel::Draw(IDirect3DDevice9* dev, Effect* fx, UnitQuad* quad)
 			fVector4 screenSize = { float(screenWidth), float(screenHeight), 1.f / screenWidth, 1.f / screenHeight };			
 			
 
-			auto activeElements = GetActiveElements();
+			const auto active = UpdateActiveElements();
+			const auto& activeElements = active->elements;
 			if (!activeElements.empty())
 			{
 				fVector4 baseSpriteDimensions;
@@ -318,18 +344,7 @@ void Wheel::Draw(IDirect3DDevice9* dev, Effect* fx, UnitQuad* quad)
 
 				fx->SetTechnique(alphaBlended_ ? EFF_TC_MOUNTIMAGE_ALPHABLEND : EFF_TC_MOUNTIMAGE);				
 				fx->SetVector(EFF_VS_SCREEN_SIZE, &screenSize);
-				fx->Begin(&passes, 0);
-				fx->BeginPass(0);
-
-				int n = 0;
-				for (auto it : activeElements)
-				{
-					it->Draw(n, baseSpriteDimensions, activeElements.size(), currentTime, currentHovered_, this);
-					n++;
-				}
-
-				fx->EndPass();
-				fx->End();
+				DrawElements(dev, fx, quad, *active, baseSpriteDimensions, hoveredFadeIns);
 			}
 
 			{
@@ -363,6 +378,37 @@ void Wheel::Sort()
 	std::sort(wheelElements_.begin(), wheelElements_.end(),
 		[](const std::unique_ptr<WheelElement>& a, const std::unique_ptr<WheelElement>& b) { return a->sortingPriority() < b->sortingPriority(); });
 	minElementSortingPriority_ = wheelElements_.front()->sortingPriority();
+	activeElementsDirty_ = true;
+}
+
+void Wheel::BuildAtlas(IDirect3DDevice9* dev)
+{
+	// The background and ink are drawn separately and sampled differently, so only element images are packed
+	std::vector<WheelElement*> elements;
+	std::vector<IDirect3DTexture9*> sources;
+	for(auto& we : wheelElements_)
+	{
+		if(we->appearance())
+		{
+			elements.push_back(we.get());
+			sources.push_back(we->appearance());
+		}
+	}
+	if(sources.size() < 2)
+		return;
+
+	std::vector<fVector4> uvRects;
+	auto* atlas = TextureAtlas::Create(dev, sources, uvRects);
+	if(!atlas)
+	{
+		FormattedOutputDebugString("Could not pack the images of wheel '%s' into an atlas, drawing them from separate textures\n", nickname_.c_str());
+		return;
+	}
+
+	// Every element now holds a reference to the atlas in place of its own texture
+	for(size_t i = 0; i < elements.size(); i++)
+		elements[i]->appearance(atlas, uvRects[i]);
+	atlas->Release();
 }
 
 WheelElement* Wheel::GetCenterHoveredElement()
@@ -390,14 +436,66 @@ WheelElement* Wheel::GetFavorite(int favoriteId)
 	return nullptr;
 }
 
-std::vector<WheelElement*> Wheel::GetActiveElements()
+std::shared_ptr<const Wheel::ActiveElements> Wheel::UpdateActiveElements()
 {
-	std::vector<WheelElement*> elems;
+	// Mounts other than the warclaw are unavailable in WvW
+	const bool isWvW = MumbleLink::i()->isWvW();
+	auto current = std::atomic_load_explicit(&activeElements_, std::memory_order_relaxed);
+	if(!activeElementsDirty_.exchange(false) && isWvW == current->isWvW)
+		return current;
+
+	auto active = std::make_shared<ActiveElements>();
 	for(auto& we : wheelElements_)
 		if(we->isActive())
-			elems.push_back(we.get());
+			active->elements.push_back(we.get());
+	active->layout = WheelLayout(active->elements.size());
+	active->isWvW = isWvW;
 
-	return elems;
+	current = std::move(active);
+	std::atomic_store_explicit(&activeElements_, current, std::memory_order_release);
+	return current;
+}
+
+void Wheel::DrawElements(IDirect3DDevice9* dev, Effect* fx, UnitQuad* quad, const ActiveElements& active, const fVector4& baseSpriteDimensions, const std::vector<float>& hoveredFadeIns)
+{
+	const auto count = uint(active.elements.size());
+
+	instanceData_.clear();
+	instanceTextures_.clear();
+	for(uint i = 0; i < count; i++)
+	{
+		const auto& placement = active.layout[i];
+
+		float diameter = placement.diameter;
+		if(count > 1)
+			diameter *= Lerp(1.f, 1.1f, SmoothStep(hoveredFadeIns[i]));
+
+		fVector4 spriteDimensions = baseSpriteDimensions;
+		spriteDimensions.x += placement.location.x * baseSpriteDimensions.z;
+		spriteDimensions.y += placement.location.y * baseSpriteDimensions.w;
+		spriteDimensions.z *= diameter;
+		spriteDimensions.w *= diameter;
+
+		instanceData_.push_back(active.elements[i]->Instance(spriteDimensions, hoveredFadeIns[i]));
+		instanceTextures_.push_back(active.elements[i]->appearance());
+	}
+
+	if(fx->instancing() && (!instances_ || instances_->capacity() < count))
+	{
+		// Sized for every element of the wheel, so showing more of them later does not need a new buffer
+		instances_.reset();
+		try
+		{
+			instances_ = std::make_unique<InstancedQuad>(dev, uint(std::max(wheelElements_.size(), size_t(count))));
+		}
+		catch(...)
+		{
+			FormattedOutputDebugString("Could not create the instance buffer for wheel '%s', drawing elements one at a time\n", nickname_.c_str());
+		}
+	}
+
+	// Elements of the wheel share its atlas, so normally this is a single draw
+	InstancedQuad::DrawAll(fx, *quad, instances_.get(), instanceData_.data(), instanceTextures_.data(), count);
 }
 
 bool Wheel::OnMouseMove()
@@ -414,17 +512,12 @@ bool Wheel::OnMouseMove()
 	return isVisible_ && lockCameraWhenOverlayedOption_.value();
 }
 
-InputResponse Wheel::OnInputChange(bool changed, const std::set<uint>& keys, const std::list<EventKey>& changedKeys)
+InputResponse Wheel::OnInputChange(bool changed, const KeyCombo& keys, const EventKeys& changedKeys)
 {
 	const bool previousVisibility = isVisible_;
 
-	bool mountOverlay = keybind_.matchesPartial(keys);
-	bool mountOverlayLocked = centralKeybind_.matchesPartial(keys);
-	
-	if(mountOverlay)
-		mountOverlay &= !keybind_.conflicts(keys);
-	if(mountOverlayLocked)
-		mountOverlayLocked &= !centralKeybind_.conflicts(keys);
+	const bool mountOverlay = KeybindMatcher::wins(keybind_, keys);
+	const bool mountOverlayLocked = KeybindMatcher::wins(centralKeybind_, keys);
 
 	isVisible_ = mountOverlayLocked || mountOverlay;
 	
@@ -479,6 +572,10 @@ InputResponse Wheel::OnInputChange(bool changed, const std::set<uint>& keys, con
 			}
 		}
 
+		// Elements without a keybind are not shown
+		if(isAnyElementBeingModified)
+			activeElementsDirty_ = true;
+
 		if(isAnyElementBeingModified)
 			return InputResponse::PREVENT_ALL;
 	}
@@ -508,6 +605,7 @@ void Wheel::ActivateWheel(bool isMountOverlayLocked)
 		currentPosition_.y = io.MousePos.y / float(Core::i()->screenHeight());
 	}
 
+	// Called from the input thread, where the frame time can be a whole frame stale, so this takes a live reading
 	currentTriggerTime_ = TimeInMilliseconds();
 	
 	inkSpot_ = { frand() * 0.20f + 0.40f, frand() * 0.20f + 0.40f, frand() * 2 * float(M_PI) };
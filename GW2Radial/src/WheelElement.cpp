@@ -62,56 +62,34 @@ int WheelElement::DrawPriority(int extremumIndicator)
 	return rv;
 }
 
-void WheelElement::Draw(int n, fVector4 spriteDimensions, size_t activeElementsCount, const mstime& currentTime, const WheelElement* elementHovered, const Wheel* parent)
+QuadInstance WheelElement::Instance(const fVector4& spriteDimensions, float hoverFadeIn)
 {
-	const float hoverTimer = hoverFadeIn(currentTime, parent);
-
-	float elementAngle = float(n) / float(activeElementsCount) * 2 * float(M_PI);
-	if (activeElementsCount == 1)
-		elementAngle = 0;
-	const fVector2 elementLocation = fVector2{cos(elementAngle - float(M_PI) / 2) * 0.2f, sin(elementAngle - float(M_PI) / 2) * 0.2f };
-
-	spriteDimensions.x += elementLocation.x * spriteDimensions.z;
-	spriteDimensions.y += elementLocation.y * spriteDimensions.w;
-
-	float elementDiameter = float(sin((2 * M_PI / double(activeElementsCount)) / 2)) * 2.f * 0.2f * 0.66f;
-	if (activeElementsCount == 1)
-		elementDiameter = 2.f * 0.2f;
-	else
-		elementDiameter *= Lerp(1.f, 1.1f, SmoothStep(hoverTimer));
-
-	switch (activeElementsCount)
-	{
-	case 1:
-		spriteDimensions.z *= 0.5f;
-		spriteDimensions.w *= 0.5f;
-		break;
-	case 2:
-		spriteDimensions.z *= 0.7f;
-		spriteDimensions.w *= 0.7f;
-		break;
-	case 3:
-		spriteDimensions.z *= 0.9f;
-		spriteDimensions.w *= 0.9f;
-		break;
-	case 4:
-		spriteDimensions.z *= 0.95f;
-		spriteDimensions.w *= 0.95f;
-		break;
-	default:
-		break;
-	}
-
-	spriteDimensions.z *= elementDiameter;
-	spriteDimensions.w *= elementDiameter;
-	
+	const auto c = color();
+
+	QuadInstance instance;
+	instance.spriteDimensions = spriteDimensions;
+	instance.uvRect = uvRect_;
+	instance.color = { c[0], c[1], c[2], c[3] };
+	instance.params = { hoverFadeIn, 0.f, 0.f, 0.f };
+	return instance;
+}
 
+void WheelElement::appearance(IDirect3DTexture9* texture, const fVector4& uvRect)
+{
+	texture->AddRef();
+	COM_RELEASE(appearance_);
+	appearance_ = texture;
+	uvRect_ = uvRect;
 }
 
 float WheelElement::hoverFadeIn(const mstime& currentTime, const Wheel* parent) const
 {
-	const auto hoverIn = std::min(1.f, (currentTime - std::max(currentHoverTime_, parent->currentTriggerTime_ + parent->displayDelayOption_.value())) / 1000.f * 6);
-	const auto hoverOut = 1.f - std::min(1.f, (currentTime - std::max(currentExitTime_, parent->currentTriggerTime_ + parent->displayDelayOption_.value())) / 1000.f * 6);
+	// Hover changes are stamped live on the input thread, so they can be slightly ahead of the frame time passed in
+	const auto elapsed = [currentTime](mstime since) { return currentTime > since ? float(currentTime - since) : 0.f; };
+	const mstime shown = parent->currentTriggerTime_ + parent->displayDelayOption_.value();
+
+	const auto hoverIn = std::min(1.f, elapsed(std::max(currentHoverTime_, shown)) / 1000.f * 6);
+	const auto hoverOut = 1.f - std::min(1.f, elapsed(std::max(currentExitTime_, shown)) / 1000.f * 6);
 
 	return parent->currentHovered_ == this ? hoverIn : std::min(hoverIn, hoverOut);
 }
@@ -0,0 +1,66 @@
+#include <WheelLayout.h>
+#include <cmath>
+
+namespace GW2Radial
+{
+
+WheelLayout::WheelLayout(size_t count)
+{
+	// Element i is centered on the angle i * elementAngle, clockwise from the top, so its sector begins half an element before
+	const float elementAngle = float(2 * M_PI) / count;
+	for(size_t i = 0; i < count; i++)
+	{
+		const float angle = 0.5f * float(M_PI) + (float(i) - 0.5f) * elementAngle;
+		sectorBoundaries_.push_back({ std::cos(angle), std::sin(angle) });
+	}
+
+	for(size_t i = 0; i < count; i++)
+	{
+		const float angle = count == 1 ? 0.f : i * elementAngle;
+		Placement placement;
+		placement.location = { std::cos(angle - float(M_PI) / 2) * 0.2f, std::sin(angle - float(M_PI) / 2) * 0.2f };
+		placement.diameter = count == 1 ? 2.f * 0.2f : float(std::sin(M_PI / double(count))) * 2.f * 0.2f * 0.66f;
+
+		switch(count)
+		{
+		case 1:
+			placement.diameter *= 0.5f;
+			break;
+		case 2:
+			placement.diameter *= 0.7f;
+			break;
+		case 3:
+			placement.diameter *= 0.9f;
+			break;
+		case 4:
+			placement.diameter *= 0.95f;
+			break;
+		default:
+			break;
+		}
+
+		placements_.push_back(placement);
+	}
+}
+
+int WheelLayout::HoveredSector(const fVector2& direction) const
+{
+	const auto cross = [](const fVector2& a, const fVector2& b) { return a.x * b.y - a.y * b.x; };
+
+	const auto count = sectorBoundaries_.size();
+	if(count < 2)
+		return 0;
+
+	for(size_t i = 0; i < count; i++)
+	{
+		const auto& begin = sectorBoundaries_[i];
+		const auto& end = sectorBoundaries_[(i + 1) % count];
+		if(cross(begin, direction) >= 0 && cross(direction, end) > 0)
+			return int(i);
+	}
+
+	// Only reachable when a two sector wheel is split exactly along the direction, which starts the sector it points along
+	return direction.x * sectorBoundaries_[0].x + direction.y * sectorBoundaries_[0].y > 0 ? 0 : 1;
+}
+
+}
@@ -0,0 +1,318 @@
+#include <AtlasPacker.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace GW2Radial
+{
+
+using Image = AtlasPacker::Image;
+using Encoding = AtlasPacker::Encoding;
+
+// Checks what Create relies on: every image on whole cells inside the atlas, with a border of one cell all around it
+// that no other image or border overlaps, and that border still at least a block wide on the smallest kept level
+static void ExpectValidLayout(const std::vector<Image>& images, const AtlasPacker::Layout& layout, uint blockSize, uint maxBorder)
+{
+	ASSERT_EQ(layout.positions.size(), images.size());
+	ASSERT_GT(layout.levels, 0u);
+	EXPECT_EQ(layout.cellSize, blockSize << (layout.levels - 1));
+	EXPECT_LE(layout.cellSize, std::max(blockSize, maxBorder));
+
+	const uint border = layout.cellSize;
+	for (size_t i = 0; i < images.size(); i++)
+	{
+		const auto& p = layout.positions[i];
+		EXPECT_EQ(p.x % layout.cellSize, 0u);
+		EXPECT_EQ(p.y % layout.cellSize, 0u);
+		EXPECT_GE(p.x, border);
+		EXPECT_GE(p.y, border);
+		EXPECT_LE(p.x + images[i].width + border, layout.width);
+		EXPECT_LE(p.y + images[i].height + border, layout.height);
+
+		for (size_t j = i + 1; j < images.size(); j++)
+		{
+			const auto& q = layout.positions[j];
+			const bool apart = p.x + images[i].width + 2 * border <= q.x || q.x + images[j].width + 2 * border <= p.x ||
+			                   p.y + images[i].height + 2 * border <= q.y || q.y + images[j].height + 2 * border <= p.y;
+			EXPECT_TRUE(apart) << "images " << i << " and " << j;
+		}
+	}
+
+	const uint lastLevelBorder = layout.cellSize >> (layout.levels - 1);
+	EXPECT_GE(lastLevelBorder, blockSize);
+}
+
+TEST(AtlasPacker, MountIcons)
+{
+	// DXT5 icons with a full mip chain, as the mount wheel has them
+	const std::vector<Image> images(10, { 128, 128 });
+	AtlasPacker::Layout layout;
+	ASSERT_TRUE(AtlasPacker::Pack(images, 4, 8, 32, 4096, true, layout));
+	ExpectValidLayout(images, layout, 4, 32);
+
+	// A 32 texel border keeps 4 levels, the last one 16 texels per icon
+	EXPECT_EQ(layout.levels, 4u);
+	EXPECT_EQ(layout.width & (layout.width - 1), 0u);
+	EXPECT_EQ(layout.height & (layout.height - 1), 0u);
+}
+
+TEST(AtlasPacker, MixedSizes)
+{
+	const std::vector<Image> images = { { 256, 128 }, { 64, 64 }, { 128, 256 }, { 64, 192 }, { 32, 32 }, { 192, 64 } };
+	AtlasPacker::Layout layout;
+	ASSERT_TRUE(AtlasPacker::Pack(images, 1, 16, 64, 2048, false, layout));
+	ExpectValidLayout(images, layout, 1, 64);
+
+	// 32 is the largest power of two dividing every side
+	EXPECT_EQ(layout.cellSize, 32u);
+	EXPECT_EQ(layout.levels, 6u);
+}
+
+TEST(AtlasPacker, LevelsLimitedByTheSources)
+{
+	const std::vector<Image> images(3, { 64, 64 });
+	AtlasPacker::Layout layout;
+	ASSERT_TRUE(AtlasPacker::Pack(images, 4, 2, 32, 4096, true, layout));
+	ExpectValidLayout(images, layout, 4, 32);
+	EXPECT_EQ(layout.levels, 2u);
+}
+
+TEST(AtlasPacker, LevelsLimitedByTheBorder)
+{
+	const std::vector<Image> images(4, { 1024, 1024 });
+	for (uint maxBorder : { 1u, 4u, 8u, 32u })
+	{
+		AtlasPacker::Layout layout;
+		ASSERT_TRUE(AtlasPacker::Pack(images, 1, 11, maxBorder, 4096, false, layout));
+		ExpectValidLayout(images, layout, 1, maxBorder);
+		EXPECT_EQ(layout.cellSize, maxBorder);
+	}
+
+	// Never narrower than a block, even if that is wider than asked for
+	AtlasPacker::Layout layout;
+	ASSERT_TRUE(AtlasPacker::Pack(images, 4, 11, 2, 4096, false, layout));
+	EXPECT_EQ(layout.levels, 1u);
+	EXPECT_EQ(layout.cellSize, 4u);
+}
+
+TEST(AtlasPacker, SingleLevelStillPadded)
+{
+	const std::vector<Image> images = { { 12, 8 }, { 8, 12 }, { 4, 4 } };
+	AtlasPacker::Layout layout;
+	ASSERT_TRUE(AtlasPacker::Pack(images, 4, 4, 32, 4096, false, layout));
+	ExpectValidLayout(images, layout, 4, 32);
+	EXPECT_EQ(layout.levels, 1u);
+}
+
+TEST(AtlasPacker, TooLargeForTheDevice)
+{
+	const std::vector<Image> images(4, { 256, 256 });
+	AtlasPacker::Layout layout;
+	EXPECT_FALSE(AtlasPacker::Pack(images, 4, 1, 32, 256, false, layout));
+	EXPECT_TRUE(layout.positions.empty());
+
+	// The border needs room on both sides
+	EXPECT_FALSE(AtlasPacker::Pack({ { 256, 256 } }, 4, 1, 32, 260, false, layout));
+	EXPECT_TRUE(AtlasPacker::Pack({ { 256, 256 } }, 4, 1, 32, 264, false, layout));
+}
+
+TEST(AtlasPacker, RejectsUnalignedImages)
+{
+	AtlasPacker::Layout layout;
+	EXPECT_FALSE(AtlasPacker::Pack({ { 64, 64 }, { 30, 64 } }, 4, 4, 32, 4096, false, layout));
+	EXPECT_FALSE(AtlasPacker::Pack({ { 0, 64 } }, 1, 4, 32, 4096, false, layout));
+	EXPECT_FALSE(AtlasPacker::Pack({}, 4, 4, 32, 4096, false, layout));
+}
+
+// What a texel of a block decodes from: the block's endpoints and the indices picking between them
+struct EncodedTexel
+{
+	std::vector<uint8_t> endpoints;
+	uint colorIndex = 0, alphaIndex = 0;
+
+	bool operator==(const EncodedTexel& other) const
+	{
+		return endpoints == other.endpoints && colorIndex == other.colorIndex && alphaIndex == other.alphaIndex;
+	}
+};
+
+static uint Index(const uint8_t* bits, uint bitsPerTexel, uint texel)
+{
+	uint64_t indices = 0;
+	memcpy(&indices, bits, bitsPerTexel * 2);
+	return uint(indices >> (texel * bitsPerTexel) & ((1u << bitsPerTexel) - 1));
+}
+
+static EncodedTexel Decode(const AtlasPacker::Format& format, const uint8_t* bits, uint pitch, uint x, uint y)
+{
+	const uint8_t* block = bits + y / format.blockSize * pitch + x / format.blockSize * format.bytesPerBlock;
+	const uint texel = y % format.blockSize * 4 + x % format.blockSize;
+
+	EncodedTexel t;
+	switch (format.encoding)
+	{
+	case Encoding::DXT1:
+		t.endpoints.assign(block, block + 4);
+		t.colorIndex = Index(block + 4, 2, texel);
+		break;
+	case Encoding::DXT3:
+		t.endpoints.assign(block + 8, block + 12);
+		t.alphaIndex = Index(block, 4, texel);
+		t.colorIndex = Index(block + 12, 2, texel);
+		break;
+	case Encoding::DXT5:
+		t.endpoints.assign(block, block + 2);
+		t.endpoints.insert(t.endpoints.end(), block + 8, block + 12);
+		t.alphaIndex = Index(block + 2, 3, texel);
+		t.colorIndex = Index(block + 12, 2, texel);
+		break;
+	default:
+		t.endpoints.assign(block, block + format.bytesPerBlock);
+		break;
+	}
+	return t;
+}
+
+// One 16x8 image at (cell, cell) with a full border, copied at every level; every texel of the image and its
+// border has to decode to the image's texel clamp addressing would read there
+static void ExpectBorderRepeatsEdges(const AtlasPacker::Format& format, uint levels)
+{
+	const Image image = { 16 * format.blockSize, 8 * format.blockSize };
+	AtlasPacker::Layout layout;
+	layout.levels = levels;
+	layout.cellSize = format.blockSize << (levels - 1);
+	layout.width = image.width + 2 * layout.cellSize;
+	layout.height = image.height + 2 * layout.cellSize;
+	const AtlasPacker::Position position = { layout.cellSize, layout.cellSize };
+
+	std::mt19937 rng(25);
+	for (uint level = 0; level < levels; level++)
+	{
+		const uint width = image.width >> level, height = image.height >> level;
+		const uint srcPitch = width / format.blockSize * format.bytesPerBlock;
+		std::vector<uint8_t> src(srcPitch * height / format.blockSize);
+		for (auto& b : src)
+			b = uint8_t(rng());
+
+		const uint dstPitch = (layout.width >> level) / format.blockSize * format.bytesPerBlock;
+		std::vector<uint8_t> dst(dstPitch * (layout.height >> level) / format.blockSize);
+		AtlasPacker::CopyLevel(layout, image, position, level, format, src.data(), srcPitch, dst.data(), dstPitch);
+
+		const int border = int(layout.cellSize >> level);
+		for (int y = -border; y < int(height) + border; y++)
+		{
+			for (int x = -border; x < int(width) + border; x++)
+			{
+				const auto expected = Decode(format, src.data(), srcPitch, std::clamp(x, 0, int(width) - 1), std::clamp(y, 0, int(height) - 1));
+				const auto actual = Decode(format, dst.data(), dstPitch, x + border, y + border);
+				ASSERT_TRUE(actual == expected) << "level " << level << " texel " << x << ", " << y;
+			}
+		}
+	}
+}
+
+TEST(AtlasPacker, BorderRepeatsEdgeTexels)
+{
+	ExpectBorderRepeatsEdges({ Encoding::Texels, 1, 1 }, 3);
+	ExpectBorderRepeatsEdges({ Encoding::Texels, 1, 4 }, 1);
+}
+
+TEST(AtlasPacker, BorderRepeatsEdgeTexelsOfCompressedBlocks)
+{
+	ExpectBorderRepeatsEdges({ Encoding::DXT1, 4, 8 }, 3);
+	ExpectBorderRepeatsEdges({ Encoding::DXT3, 4, 16 }, 2);
+	ExpectBorderRepeatsEdges({ Encoding::DXT5, 4, 16 }, 3);
+}
+
+// The size, levels and format in a DDS file's header, as D3DX reads them when creating a wheel element's texture
+struct DdsHeader
+{
+	Image image { };
+	uint levels = 0;
+	AtlasPacker::Format format { };
+};
+
+static bool ReadDdsHeader(const std::string& path, DdsHeader& header)
+{
+	std::ifstream file(path, std::ios::binary);
+	uint8_t bytes[128];
+	if (!file.read(reinterpret_cast<char*>(bytes), sizeof(bytes)) || memcmp(bytes, "DDS ", 4) != 0)
+		return false;
+
+	const auto field = [&bytes](size_t offset) { uint32_t v; memcpy(&v, bytes + offset, sizeof(v)); return v; };
+	header.image = { field(16), field(12) };
+	header.levels = std::max(1u, field(28));
+
+	constexpr uint32_t FourCC = 0x4, Luminance = 0x20000;
+	const auto flags = field(80);
+	if (flags & FourCC)
+	{
+		if (memcmp(bytes + 84, "DXT1", 4) == 0)
+			header.format = { Encoding::DXT1, 4, 8 };
+		else if (memcmp(bytes + 84, "DXT5", 4) == 0)
+			header.format = { Encoding::DXT5, 4, 16 };
+		else
+			return false;
+	}
+	else if ((flags & Luminance) && field(88) == 8)
+		header.format = { Encoding::Texels, 1, 1 };
+	else
+		return false;
+
+	return true;
+}
+
+struct WheelArt
+{
+	const char* wheel;
+	std::vector<const char*> files;
+	// Largest atlas allowed on a device limited to power of two textures of at most 4096 texels
+	uint maxWidth, maxHeight;
+};
+
+class AtlasPackerArt : public testing::TestWithParam<WheelArt> { };
+
+TEST_P(AtlasPackerArt, PacksIntoOneTexture)
+{
+	const auto& art = GetParam();
+	std::vector<Image> images;
+	AtlasPacker::Format format { };
+	uint levels = ~0u;
+	uint64_t imageArea = 0;
+	for (const auto* file : art.files)
+	{
+		DdsHeader header;
+		ASSERT_TRUE(ReadDdsHeader(std::string(GW2RADIAL_ART_DIR) + "/" + file + ".dds", header)) << file;
+		if (!images.empty())
+			ASSERT_EQ(header.format.encoding, format.encoding) << file;
+
+		images.push_back(header.image);
+		format = header.format;
+		levels = std::min(levels, header.levels);
+		imageArea += uint64_t(header.image.width) * header.image.height;
+	}
+
+	// As TextureAtlas::Create does it, with and without the power of two restriction
+	AtlasPacker::Layout layout;
+	ASSERT_TRUE(AtlasPacker::Pack(images, format.blockSize, levels, 32, 4096, false, layout));
+	ExpectValidLayout(images, layout, format.blockSize, 32);
+	EXPECT_LE(uint64_t(layout.width) * layout.height, imageArea * 3 / 2);
+
+	ASSERT_TRUE(AtlasPacker::Pack(images, format.blockSize, levels, 32, 4096, true, layout));
+	ExpectValidLayout(images, layout, format.blockSize, 32);
+	EXPECT_LE(layout.width, art.maxWidth);
+	EXPECT_LE(layout.height, art.maxHeight);
+}
+
+INSTANTIATE_TEST_SUITE_P(Wheels, AtlasPackerArt, testing::Values(
+	WheelArt { "Mounts", { "Raptor", "Springer", "Skimmer", "Jackal", "Beetle", "Griffon", "Warclaw", "Skyscale" }, 4096, 4096 },
+	WheelArt { "Novelties", { "chair", "music", "hand", "travel", "tonic" }, 4096, 4096 },
+	WheelArt { "Markers", { "arrow_marker", "circle_marker", "heart_marker", "square_marker", "star_marker",
+	                        "spiral_marker", "triangle_marker", "x_marker", "clear_markers" }, 512, 512 }),
+	[](const testing::TestParamInfo<WheelArt>& info) { return std::string(info.param.wheel); });
+
+}
@@ -0,0 +1,115 @@
+#include <Base64.h>
+#include "Baseline.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <random>
+#include <vector>
+
+namespace GW2Radial
+{
+
+static std::string Encode(const std::vector<uint8_t>& bytes)
+{
+	std::string out;
+	size_t i = 0;
+	for (; i + 3 <= bytes.size(); i += 3)
+	{
+		const uint32_t bits = uint32_t(bytes[i]) << 16 | uint32_t(bytes[i + 1]) << 8 | bytes[i + 2];
+		for (int k = 3; k >= 0; k--)
+			out += Baseline::base64_chars[(bits >> (6 * k)) & 0x3F];
+	}
+
+	const size_t rest = bytes.size() - i;
+	if (rest > 0)
+	{
+		const uint32_t bits = uint32_t(bytes[i]) << 16 | (rest > 1 ? uint32_t(bytes[i + 1]) << 8 : 0);
+		for (size_t k = 0; k <= rest; k++)
+			out += Baseline::base64_chars[(bits >> (18 - 6 * k)) & 0x3F];
+		out.append(3 - rest, '=');
+	}
+	return out;
+}
+
+static std::string Decode(const std::string& encoded)
+{
+	std::vector<uint8_t> out(Base64DecodedSize(encoded.size()));
+	const auto size = Base64Decode(std::wstring(encoded.begin(), encoded.end()), out.data(), out.size());
+	return std::string(out.begin(), out.begin() + size);
+}
+
+TEST(Base64, DecodedSize)
+{
+	EXPECT_EQ(Base64DecodedSize(0), 0u);
+	EXPECT_EQ(Base64DecodedSize(1), 0u);
+	EXPECT_EQ(Base64DecodedSize(2), 1u);
+	EXPECT_EQ(Base64DecodedSize(3), 2u);
+	EXPECT_EQ(Base64DecodedSize(4), 3u);
+	EXPECT_EQ(Base64DecodedSize(7), 5u);
+}
+
+TEST(Base64, KnownValues)
+{
+	EXPECT_EQ(Decode("Zm9vYmFy"), "foobar");
+	EXPECT_EQ(Decode("Zm9vYg=="), "foob");
+	EXPECT_EQ(Decode("Zm9vYg"), "foob");
+	EXPECT_EQ(Decode("Zm9vYmE="), "fooba");
+	EXPECT_EQ(Decode("Zm9v!mFy"), "foo");
+	EXPECT_EQ(Decode("Z"), "");
+	EXPECT_EQ(Decode(""), "");
+}
+
+// Random bytes of every length up to 64, encoded with and without padding, must decode to the bytes
+// and to the same thing the original decoder gave
+TEST(Base64, RoundTripMatchesBaseline)
+{
+	std::mt19937 rng(42);
+	std::uniform_int_distribution<int> byte(0, 255);
+	for (size_t length = 0; length <= 64; length++)
+	{
+		for (int sample = 0; sample < 20; sample++)
+		{
+			std::vector<uint8_t> bytes(length);
+			for (auto& b : bytes)
+				b = uint8_t(byte(rng));
+
+			const std::string expected(bytes.begin(), bytes.end());
+			auto encoded = Encode(bytes);
+			ASSERT_EQ(Decode(encoded), expected);
+			ASSERT_EQ(Baseline::base64_decode(encoded), expected);
+
+			while (!encoded.empty() && encoded.back() == '=')
+				encoded.pop_back();
+			ASSERT_EQ(Decode(encoded), expected);
+			ASSERT_EQ(Baseline::base64_decode(encoded), expected);
+		}
+	}
+}
+
+// Inputs which are not clean base64 stop where the original decoder stopped
+TEST(Base64, GarbageMatchesBaseline)
+{
+	static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/=!-_ ";
+	std::mt19937 rng(7);
+	std::uniform_int_distribution<size_t> length(0, 24), character(0, sizeof(alphabet) - 2);
+	for (int sample = 0; sample < 20000; sample++)
+	{
+		std::string encoded(length(rng), ' ');
+		for (auto& c : encoded)
+			c = alphabet[character(rng)];
+		ASSERT_EQ(Decode(encoded), Baseline::base64_decode(encoded)) << "input: " << encoded;
+	}
+}
+
+TEST(Base64, NeverWritesPastOutput)
+{
+	const std::wstring encoded = L"Zm9vYmFyYmF6";
+	std::array<uint8_t, 8> out;
+	out.fill(0xCC);
+	EXPECT_EQ(Base64Decode(encoded, out.data(), 4), 4u);
+	EXPECT_EQ(std::string(out.begin(), out.begin() + 4), "foob");
+	EXPECT_EQ(out[4], 0xCC);
+
+	EXPECT_EQ(Base64Decode(L"Zm9v\x0100", out.data(), out.size()), 3u);
+}
+
+}
@@ -0,0 +1,86 @@
+#pragma once
+// The chat parsing code ChatMessage and Base64 replaced, as it was in Core.cpp,
+// kept so tests can check the new code still gives the same answers and benchmarks can compare against it
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <regex>
+#include <string>
+
+namespace GW2Radial::Baseline
+{
+
+inline bool ChatQuoteRegex(const std::wstring& base, std::wstring& link, std::wstring& body)
+{
+	std::wregex rgx(L".*quote>\\[&(.*)\\]: (.*)$");
+	std::wsmatch match;
+	if (!std::regex_search(base.begin(), base.end(), match, rgx))
+		return false;
+
+	link = match[1];
+	body = match[2];
+	return true;
+}
+
+inline const std::string base64_chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+inline bool is_base64(unsigned char c)
+{
+	return (isalnum(c) || (c == '+') || (c == '/'));
+}
+
+inline std::string base64_decode(std::string const& encoded_string)
+{
+	int in_len = int(encoded_string.size());
+	int i = 0;
+	int j = 0;
+	int in_ = 0;
+	unsigned char char_array_4[4], char_array_3[3];
+	std::string ret;
+
+	while (in_len-- && (encoded_string[in_] != '=') && is_base64(encoded_string[in_])) {
+		char_array_4[i++] = encoded_string[in_]; in_++;
+		if (i == 4) {
+			for (i = 0; i < 4; i++)
+				char_array_4[i] = uint8_t(base64_chars.find(char_array_4[i]));
+
+			char_array_3[0] = (char_array_4[0] << 2) + ((char_array_4[1] & 0x30) >> 4);
+			char_array_3[1] = ((char_array_4[1] & 0xf) << 4) + ((char_array_4[2] & 0x3c) >> 2);
+			char_array_3[2] = ((char_array_4[2] & 0x3) << 6) + char_array_4[3];
+
+			for (i = 0; (i < 3); i++)
+				ret += char_array_3[i];
+			i = 0;
+		}
+	}
+
+	if (i) {
+		for (j = 0; j < i; j++)
+			char_array_4[j] = uint8_t(base64_chars.find(char_array_4[j]));
+
+		char_array_3[0] = (char_array_4[0] << 2) + ((char_array_4[1] & 0x30) >> 4);
+		char_array_3[1] = ((char_array_4[1] & 0xf) << 4) + ((char_array_4[2] & 0x3c) >> 2);
+
+		for (j = 0; (j < i - 1); j++) ret += char_array_3[j];
+	}
+
+	return ret;
+}
+
+// The whole per line step, sender and body joined, or NONE for lines which are not chat messages
+inline std::wstring FilterShit(const std::wstring& base)
+{
+	std::wstring b64name, text;
+	ChatQuoteRegex(base, b64name, text);
+
+	const std::string decode = base64_decode(std::string(b64name.begin(), b64name.end()));
+	wchar_t username[255] = { };
+	if (decode.length() > 17)
+		memcpy(username, decode.c_str() + 17, std::min(decode.length() - 17, sizeof(username) - sizeof(wchar_t)));
+
+	if (std::wstring(username).empty() || text.empty())
+		return L"NONE";
+	return std::wstring(username) + L": " + text;
+}
+
+}
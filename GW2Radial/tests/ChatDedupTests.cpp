@@ -0,0 +1,91 @@
+#include <ChatDedup.h>
+#include <gtest/gtest.h>
+#include <deque>
+#include <random>
+#include <string>
+
+namespace GW2Radial
+{
+
+TEST(ChatDedup, SuppressesRepeatsWhetherOrNotAdjacent)
+{
+	ChatDedup dedup({ 16, 0 });
+	EXPECT_TRUE(dedup.Admit(L"LFG world boss", 0));
+	EXPECT_FALSE(dedup.Admit(L"LFG world boss", 1));
+	EXPECT_TRUE(dedup.Admit(L"on my way", 2));
+	EXPECT_FALSE(dedup.Admit(L"LFG world boss", 3));
+	EXPECT_TRUE(dedup.Admit(L"LFG world boss!", 4));
+
+	EXPECT_EQ(dedup.admitted(), 3u);
+	EXPECT_EQ(dedup.suppressed(), 2u);
+}
+
+TEST(ChatDedup, WindowSlidesWithTime)
+{
+	ChatDedup dedup({ 16, 1000 });
+	EXPECT_TRUE(dedup.Admit(L"spam", 0));
+	EXPECT_FALSE(dedup.Admit(L"spam", 999));
+
+	// Suppressed lines do not restart the window, only admitted ones start it
+	EXPECT_TRUE(dedup.Admit(L"spam", 1000));
+	EXPECT_FALSE(dedup.Admit(L"spam", 1999));
+	EXPECT_TRUE(dedup.Admit(L"spam", 2000));
+}
+
+TEST(ChatDedup, WindowSlidesWithLineCount)
+{
+	ChatDedup dedup({ 3, 0 });
+	EXPECT_TRUE(dedup.Admit(L"a", 0));
+	EXPECT_TRUE(dedup.Admit(L"b", 0));
+	EXPECT_TRUE(dedup.Admit(L"c", 0));
+	EXPECT_FALSE(dedup.Admit(L"a", 0));
+
+	// Pushes a out of the last three admitted lines
+	EXPECT_TRUE(dedup.Admit(L"d", 0));
+	EXPECT_TRUE(dedup.Admit(L"a", 0));
+	EXPECT_FALSE(dedup.Admit(L"c", 0));
+}
+
+TEST(ChatDedup, ClearForgetsEverything)
+{
+	ChatDedup dedup({ 8, 0 });
+	dedup.Admit(L"a", 0);
+	dedup.Clear();
+	EXPECT_TRUE(dedup.Admit(L"a", 0));
+}
+
+// Checks the hash set, including its backward shift deletion, against a plain list of the window's lines
+TEST(ChatDedup, MatchesReferenceWindow)
+{
+	for (const ChatDedup::Limits limits : { ChatDedup::Limits { 4, 0 }, ChatDedup::Limits { 64, 0 }, ChatDedup::Limits { 64, 50 }, ChatDedup::Limits { 1000, 200 } })
+	{
+		ChatDedup dedup(limits);
+		std::deque<std::pair<std::wstring, mstime>> window;
+
+		std::mt19937 rng(limits.maxLines * 31 + limits.window);
+		// Few distinct lines, so repeats land both inside and outside the window
+		std::uniform_int_distribution<int> line(0, int(limits.maxLines) * 2);
+		std::uniform_int_distribution<int> step(0, 3);
+
+		mstime time = 0;
+		for (int i = 0; i < 20000; i++)
+		{
+			time += step(rng);
+			const auto text = L"line " + std::to_wstring(line(rng));
+
+			while (!window.empty() && limits.window != 0 && time - window.front().second >= limits.window)
+				window.pop_front();
+			const bool expected = std::find_if(window.begin(), window.end(), [&](const auto& w) { return w.first == text; }) == window.end();
+			if (expected)
+			{
+				if (window.size() == limits.maxLines)
+					window.pop_front();
+				window.push_back({ text, time });
+			}
+
+			ASSERT_EQ(dedup.Admit(text, time), expected) << "line " << i << " with " << limits.maxLines << " lines, " << limits.window << " ms";
+		}
+	}
+}
+
+}
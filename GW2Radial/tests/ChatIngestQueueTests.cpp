@@ -0,0 +1,91 @@
+#include <ChatIngestQueue.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace GW2Radial
+{
+
+TEST(ChatIngestQueue, DrainsInOrder)
+{
+	ChatIngestQueue<4, 16> queue;
+	EXPECT_TRUE(queue.empty());
+	EXPECT_TRUE(queue.Push(L"one", 1));
+	EXPECT_TRUE(queue.Push(L"two", 2));
+
+	std::vector<std::wstring> lines;
+	EXPECT_EQ(queue.Drain([&](const auto& slot) { lines.emplace_back(slot.text, slot.length); EXPECT_EQ(slot.time, lines.size()); }), 2u);
+	EXPECT_EQ(lines, (std::vector<std::wstring> { L"one", L"two" }));
+	EXPECT_TRUE(queue.empty());
+}
+
+TEST(ChatIngestQueue, DropsWhenFull)
+{
+	ChatIngestQueue<2, 8> queue;
+	EXPECT_TRUE(queue.Push(L"a", 0));
+	EXPECT_TRUE(queue.Push(L"b", 0));
+	EXPECT_FALSE(queue.Push(L"c", 0));
+	EXPECT_EQ(queue.droppedFull(), 1u);
+
+	queue.Drain([](const auto&) { });
+	EXPECT_TRUE(queue.Push(L"d", 0));
+	EXPECT_EQ(queue.droppedFull(), 1u);
+}
+
+TEST(ChatIngestQueue, OverflowPolicies)
+{
+	ChatIngestQueue<2, 4> truncating(ChatOverflowPolicy::TRUNCATE);
+	EXPECT_TRUE(truncating.Push(L"abc", 0));
+	EXPECT_TRUE(truncating.Push(L"abcdef", 0));
+	EXPECT_EQ(truncating.truncated(), 1u);
+
+	std::vector<std::wstring> lines;
+	truncating.Drain([&](const auto& slot) { lines.emplace_back(slot.text); });
+	EXPECT_EQ(lines, (std::vector<std::wstring> { L"abc", L"abc" }));
+
+	ChatIngestQueue<2, 4> dropping(ChatOverflowPolicy::DROP);
+	EXPECT_FALSE(dropping.Push(L"abcd", 0));
+	EXPECT_EQ(dropping.droppedOversized(), 1u);
+	EXPECT_TRUE(dropping.empty());
+}
+
+// One thread pushes numbered lines as fast as it can while another drains them;
+// every line must come out whole, once and in order, and the rest be counted as dropped
+TEST(ChatIngestQueue, StressSingleProducerSingleConsumer)
+{
+	constexpr uint64_t count = 200000;
+	auto queue = std::make_unique<ChatIngestQueue<64, 32>>();
+
+	std::thread producer([&]()
+	{
+		for (uint64_t i = 0; i < count; i++)
+		{
+			const auto text = L"line " + std::to_wstring(i);
+			queue->Push(text.c_str(), i);
+		}
+	});
+
+	uint64_t received = 0;
+	uint64_t last = 0;
+	bool ordered = true, intact = true;
+	const auto consume = [&](const auto& slot)
+	{
+		ordered &= received == 0 || slot.time > last;
+		intact &= std::wstring(slot.text, slot.length) == L"line " + std::to_wstring(slot.time);
+		last = slot.time;
+		received++;
+	};
+
+	while (received + queue->droppedFull() < count)
+		queue->Drain(consume);
+	producer.join();
+	queue->Drain(consume);
+
+	EXPECT_TRUE(ordered);
+	EXPECT_TRUE(intact);
+	EXPECT_EQ(received + queue->droppedFull(), count);
+	EXPECT_GT(received, 0u);
+}
+
+}
@@ -0,0 +1,157 @@
+#include <ChatLink.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace GW2Radial
+{
+
+// Links as they appear in game chat, between the [& and the ]
+struct LinkSample
+{
+	const wchar_t* encoded;
+	ChatLinkType type;
+	const char* description;
+};
+
+static const LinkSample LinkSamples[] =
+{
+	{ L"AdsnAAA=", ChatLinkType::COIN, "[1g 2s 3c]" },
+	{ L"AgH1WQAA", ChatLinkType::ITEM, "[Item 23029]" },
+	{ L"AgX1WQAA", ChatLinkType::ITEM, "[5 x Item 23029]" },
+	{ L"AgGqtgDgfQ4AAP9fAAAnYAAA", ChatLinkType::ITEM, "[Item 46762]" },
+	{ L"AxcnAAA=", ChatLinkType::NPC_TEXT, "[Text 10007]" },
+	{ L"BDgAAAA=", ChatLinkType::MAP, "[Map 56]" },
+	{ L"BucCAAA=", ChatLinkType::SKILL, "[Skill 743]" },
+	{ L"B/IDAAA=", ChatLinkType::TRAIT, "[Trait 1010]" },
+	{ L"CGFMngACJRHqgbaVEDwNZJJNAGkAeQB1AGsAaQBuAHkAYQAAAA==", ChatLinkType::PLAYER, "[Miyukinya]" },
+	{ L"CQIAAAA=", ChatLinkType::RECIPE, "[Recipe 2]" },
+	{ L"CgEAAAA=", ChatLinkType::WARDROBE, "[Skin 1]" },
+	{ L"CwQAAAA=", ChatLinkType::OUTFIT, "[Outfit 4]" },
+	{ L"DAYAAAAOAAAA", ChatLinkType::WVW_OBJECTIVE, "[Objective 14-6]" },
+};
+
+TEST(ChatLink, CapturedSamples)
+{
+	for (const auto& sample : LinkSamples)
+	{
+		ChatLinkBuffer buffer;
+		const auto link = DecodeChatLink(sample.encoded, buffer);
+		ASSERT_TRUE(link.valid()) << sample.description;
+		EXPECT_EQ(link.type(), sample.type) << sample.description;
+
+		std::string description;
+		link.Describe(description);
+		EXPECT_EQ(description, sample.description);
+	}
+}
+
+TEST(ChatLink, Accessors)
+{
+	ChatLinkBuffer buffer;
+	EXPECT_EQ(DecodeChatLink(L"AdsnAAA=", buffer).coins(), 10203u);
+	EXPECT_EQ(DecodeChatLink(L"BucCAAA=", buffer).id(), 743u);
+
+	const auto item = DecodeChatLink(L"AgGqtgDgfQ4AAP9fAAAnYAAA", buffer);
+	EXPECT_EQ(item.itemCount(), 1);
+	EXPECT_EQ(item.itemId(), 46762u);
+	EXPECT_EQ(item.itemSkinId(), 3709u);
+	EXPECT_EQ(item.itemUpgrade1Id(), 24575u);
+	EXPECT_EQ(item.itemUpgrade2Id(), 24615u);
+
+	const auto plain = DecodeChatLink(L"AgH1WQAA", buffer);
+	EXPECT_EQ(plain.itemSkinId(), 0u);
+	EXPECT_EQ(plain.itemUpgrade1Id(), 0u);
+	EXPECT_EQ(plain.itemUpgrade2Id(), 0u);
+
+	const auto objective = DecodeChatLink(L"DAYAAAAOAAAA", buffer);
+	EXPECT_EQ(objective.id(), 6u);
+	EXPECT_EQ(objective.wvwMapId(), 14u);
+}
+
+TEST(ChatLink, PlayerName)
+{
+	ChatLinkBuffer buffer;
+	const auto link = DecodeChatLink(L"CGFMngACJRHqgbaVEDwNZJJNAGkAeQB1AGsAaQBuAHkAYQAAAA==", buffer);
+
+	wchar_t name[32];
+	EXPECT_EQ(link.playerName(name, std::size(name)), 9u);
+	EXPECT_STREQ(name, L"Miyukinya");
+
+	// Always terminated, even when cut short
+	wchar_t shortName[4];
+	EXPECT_EQ(link.playerName(shortName, std::size(shortName)), 3u);
+	EXPECT_STREQ(shortName, L"Miy");
+
+	// Only player links have a name
+	EXPECT_EQ(DecodeChatLink(L"BucCAAA=", buffer).playerName(name, std::size(name)), 0u);
+	EXPECT_STREQ(name, L"");
+}
+
+// Every type byte with every payload length up to 32: only known types with their whole fixed payload are valid
+TEST(ChatLink, ValidatesEveryTypeAndLength)
+{
+	const auto fixedSize = [](uint8_t type) -> int
+	{
+		switch (ChatLinkType(type))
+		{
+		case ChatLinkType::COIN: case ChatLinkType::NPC_TEXT: case ChatLinkType::MAP: case ChatLinkType::SKILL:
+		case ChatLinkType::TRAIT: case ChatLinkType::RECIPE: case ChatLinkType::WARDROBE: case ChatLinkType::OUTFIT:
+			return 4;
+		case ChatLinkType::ITEM:
+			return 5;
+		case ChatLinkType::PLAYER:
+			return 16;
+		case ChatLinkType::WVW_OBJECTIVE:
+			return 8;
+		default:
+			return -1;
+		}
+	};
+
+	std::vector<uint8_t> bytes(33, 0);
+	for (int type = 0; type < 256; type++)
+	{
+		bytes[0] = uint8_t(type);
+		for (size_t payload = 0; payload + 1 <= bytes.size(); payload++)
+		{
+			const ChatLink link(bytes.data(), payload + 1);
+			const bool expected = fixedSize(uint8_t(type)) >= 0 && payload >= size_t(fixedSize(uint8_t(type)));
+			ASSERT_EQ(link.valid(), expected) << "type " << type << ", payload " << payload;
+			if (expected)
+				EXPECT_EQ(link.type(), ChatLinkType(type));
+		}
+	}
+
+	EXPECT_FALSE(ChatLink(bytes.data(), 0).valid());
+}
+
+TEST(ChatLink, ItemNeedsItsOptionalIds)
+{
+	// Flags announce a skin and both upgrades, so twelve more bytes must follow
+	std::vector<uint8_t> bytes { 0x02, 0x01, 0xAA, 0xB6, 0x00, 0xE0 };
+	for (int extra = 0; extra < 12; extra++)
+	{
+		EXPECT_FALSE(ChatLink(bytes.data(), bytes.size()).valid()) << extra;
+		bytes.push_back(0);
+	}
+	EXPECT_TRUE(ChatLink(bytes.data(), bytes.size()).valid());
+}
+
+TEST(ChatLink, RejectsMalformedText)
+{
+	ChatLinkBuffer buffer;
+	EXPECT_FALSE(DecodeChatLink(L"", buffer).valid());
+	EXPECT_FALSE(DecodeChatLink(L"!!!!", buffer).valid());
+	EXPECT_FALSE(DecodeChatLink(L"Bu", buffer).valid());
+	EXPECT_FALSE(DecodeChatLink(L"/////////////", buffer).valid());
+
+	// Longer than the buffer holds: decoding stops at its end instead of overrunning it
+	std::wstring overlong = L"CGFMngACJRHqgbaVEDwNZJJN";
+	while (overlong.size() < ChatLinkBuffer::MaxEncodedLength * 2)
+		overlong += L"AGkA";
+	const auto link = DecodeChatLink(overlong, buffer);
+	EXPECT_TRUE(link.valid());
+	EXPECT_LE(buffer.size, buffer.bytes.size());
+}
+
+}
@@ -0,0 +1,134 @@
+#include <ChatLog.h>
+#include <gtest/gtest.h>
+#include <string>
+
+namespace GW2Radial
+{
+
+// Sent by Miyukinya, so the stored text is "Miyukinya: " followed by the body
+static std::wstring Line(const std::wstring& body)
+{
+	return L"<quote>[&CGFMngACJRHqgbaVEDwNZJJNAGkAeQB1AGsAaQBuAHkAYQAAAA==]: " + body;
+}
+
+static constexpr size_t SenderBytes = sizeof("Miyukinya: ") - 1;
+
+TEST(ChatLog, KeepsMessagesInOrder)
+{
+	ChatLog log({ 10, 0, 1024 });
+	EXPECT_TRUE(log.Append(Line(L"one"), 1));
+	EXPECT_TRUE(log.Append(Line(L"two"), 2));
+	EXPECT_FALSE(log.Append(L"not a chat line", 3));
+
+	ASSERT_EQ(log.size(), 2u);
+	EXPECT_EQ(log[0].text(), "Miyukinya: one");
+	EXPECT_EQ(log[0].sender(), "Miyukinya");
+	EXPECT_EQ(log[1].body(), "two");
+	EXPECT_EQ(log[1].time(), 2u);
+	EXPECT_EQ(log[1].serial(), log[0].serial() + 1);
+	EXPECT_EQ(log.bytes(), 2 * SenderBytes + 6);
+}
+
+TEST(ChatLog, LineLimitEvictsOldest)
+{
+	ChatLog log({ 3, 0, 1024 });
+	for (int i = 0; i < 5; i++)
+		log.Append(Line(std::to_wstring(i)), i);
+
+	ASSERT_EQ(log.size(), 3u);
+	EXPECT_EQ(log[0].body(), "2");
+	EXPECT_EQ(log[2].body(), "4");
+	EXPECT_EQ(log.evicted(), 2u);
+	EXPECT_EQ(log.bytes(), 3 * (SenderBytes + 1));
+}
+
+TEST(ChatLog, AgeLimitPrunesOnlyExpired)
+{
+	ChatLog log({ 10, 1000, 1024 });
+	log.Append(Line(L"old"), 100);
+	log.Append(Line(L"newer"), 600);
+	log.Append(Line(L"newest"), 1500);
+
+	log.Prune(1100);
+	EXPECT_EQ(log.size(), 3u);
+
+	log.Prune(1101);
+	ASSERT_EQ(log.size(), 2u);
+	EXPECT_EQ(log[0].body(), "newer");
+
+	log.Prune(5000);
+	EXPECT_TRUE(log.empty());
+	EXPECT_EQ(log.bytes(), 0u);
+}
+
+TEST(ChatLog, NoAgeLimitKeepsEverything)
+{
+	ChatLog log({ 10, 0, 1024 });
+	log.Append(Line(L"forever"), 0);
+	log.Prune(~mstime(0));
+	EXPECT_EQ(log.size(), 1u);
+}
+
+TEST(ChatLog, SizeLimitEvictsUntilTheNewLineFits)
+{
+	const size_t lineBytes = SenderBytes + 10;
+	ChatLog log({ 100, 0, 3 * lineBytes });
+	for (int i = 0; i < 3; i++)
+		log.Append(Line(L"0123456789"), i);
+	EXPECT_EQ(log.bytes(), 3 * lineBytes);
+
+	// Twice the size, so both of the oldest two go
+	log.Append(Line(L"01234567890123456789"), 3);
+	ASSERT_EQ(log.size(), 2u);
+	EXPECT_EQ(log[0].time(), 2u);
+	EXPECT_EQ(log.bytes(), lineBytes + lineBytes + 10);
+	EXPECT_LE(log.bytes(), log.limits().maxBytes);
+}
+
+TEST(ChatLog, OversizedLineKeepsHistory)
+{
+	ChatLog log({ 10, 0, 64 });
+	log.Append(Line(L"kept"), 1);
+	log.Append(Line(L"also kept"), 2);
+	const auto bytes = log.bytes();
+
+	EXPECT_TRUE(log.Append(Line(std::wstring(100, L'x')), 3));
+	ASSERT_EQ(log.size(), 2u);
+	EXPECT_EQ(log[0].body(), "kept");
+	EXPECT_EQ(log[1].body(), "also kept");
+	EXPECT_EQ(log.bytes(), bytes);
+	EXPECT_EQ(log.evicted(), 1u);
+
+	// Nothing of the rejected line is left in the slot it was parsed into
+	log.Append(Line(L"next"), 4);
+	EXPECT_EQ(log[2].text(), "Miyukinya: next");
+}
+
+TEST(ChatLog, ShrinkingLimitsKeepsNewest)
+{
+	ChatLog log({ 10, 0, 1024 });
+	for (int i = 0; i < 6; i++)
+		log.Append(Line(std::to_wstring(i)), i);
+
+	log.limits({ 4, 0, 1024 });
+	ASSERT_EQ(log.size(), 4u);
+	EXPECT_EQ(log[0].body(), "2");
+
+	log.limits({ 4, 0, 2 * (SenderBytes + 1) });
+	ASSERT_EQ(log.size(), 2u);
+	EXPECT_EQ(log[0].body(), "4");
+	EXPECT_EQ(log.evicted(), 4u);
+}
+
+TEST(ChatLog, SlotsAreReused)
+{
+	ChatLog log({ 4, 0, 4096 });
+	for (int i = 0; i < 100; i++)
+		log.Append(Line(std::to_wstring(i)), i);
+
+	EXPECT_EQ(log.capacity(), 5u);
+	EXPECT_EQ(log.size(), 4u);
+	EXPECT_EQ(log[3].body(), "99");
+}
+
+}
@@ -0,0 +1,102 @@
+#include <ChatMessage.h>
+#include "Baseline.h"
+#include <gtest/gtest.h>
+#include <random>
+
+namespace GW2Radial
+{
+
+// Hand written lines around the edges of the <quote>[&link]: body grammar
+static const wchar_t* const ChatQuoteCorpus[] =
+{
+	L"<quote>[&CGFMngACJRHqgbaVEDwNZJJNAGkAeQB1AGsAaQBuAHkAYQAAAA==]: message text",
+	L"<quote>[&CGFMngACJRHqgbaVEDwNZJJNAGkAeQB1AGsAaQBuAHkAYQAAAA==]: ",
+	L"<quote>[&]: empty link",
+	L"<quote>[&abc]:no space",
+	L"<quote>[&abc] : space before colon",
+	L"quote>[&abc]: no opening bracket",
+	L"<quote>[&abc]: body with ]: a second separator",
+	L"<quote>[&abc]: body with <quote>[&def]: a second quote",
+	L"<quote>[&a]: b]: c quote>[&d]: e",
+	L"<quote>[&first\nline]: split link",
+	L"first line\n<quote>[&abc]: second line",
+	L"<quote>[&abc]: first line\nsecond line",
+	L"<quote>[&abc]: carriage\rreturn",
+	L"<quote>[&abc]: line separator",
+	L"<quote>[&abc]: Grüße aus Löwenstein",
+	L"]: quote>[&",
+	L"quote>[&]: ",
+	L"quote>[&",
+	L"]: ",
+	L"",
+	L"plain text without any quote",
+};
+
+static void ExpectSameAsRegex(const std::wstring& line)
+{
+	std::wstring regexLink, regexBody;
+	const bool regexMatched = Baseline::ChatQuoteRegex(line, regexLink, regexBody);
+
+	std::wstring_view link, body;
+	const bool matched = ScanChatQuote(line, link, body);
+
+	ASSERT_EQ(matched, regexMatched) << "line: " << utf8_encode(line);
+	if (matched)
+	{
+		EXPECT_EQ(std::wstring(link), regexLink) << "line: " << utf8_encode(line);
+		EXPECT_EQ(std::wstring(body), regexBody) << "line: " << utf8_encode(line);
+	}
+}
+
+TEST(ScanChatQuote, CorpusMatchesRegex)
+{
+	for (const auto* line : ChatQuoteCorpus)
+		ExpectSameAsRegex(line);
+}
+
+// Random lines stitched together from the grammar's pieces, which is where the two could disagree
+TEST(ScanChatQuote, FuzzMatchesRegex)
+{
+	static const wchar_t* const pieces[] = { L"<quote>", L"quote>[&", L"quote>", L"[&", L"[", L"&", L"]: ", L"]", L":", L" ", L"\n", L"\r", L" ", L"Zm9v", L"A", L"=", L"ü", L"q" };
+
+	std::mt19937 rng(1234);
+	std::uniform_int_distribution<size_t> pieceCount(0, 14), piece(0, std::size(pieces) - 1);
+	for (int i = 0; i < 20000; i++)
+	{
+		std::wstring line;
+		for (size_t n = pieceCount(rng); n > 0; n--)
+			line += pieces[piece(rng)];
+		ExpectSameAsRegex(line);
+		if (HasFatalFailure())
+			return;
+	}
+}
+
+TEST(ScanChatQuote, RejectsLongMalformedLines)
+{
+	// Would take quadratic time with the regex's leading .*
+	std::wstring line;
+	for (int i = 0; i < 100000; i++)
+		line += L"quote>[&]:";
+
+	std::wstring_view link, body;
+	EXPECT_FALSE(ScanChatQuote(line, link, body));
+	line += L"]: end";
+	EXPECT_TRUE(ScanChatQuote(line, link, body));
+	EXPECT_EQ(body, L"end");
+}
+
+TEST(ParseChatMessage, SenderAndBody)
+{
+	ChatMessage message;
+	ASSERT_TRUE(ParseChatMessage(L"<quote>[&CGFMngACJRHqgbaVEDwNZJJNAGkAeQB1AGsAaQBuAHkAYQAAAA==]: Grüße", message));
+	EXPECT_EQ(message.sender(), "Miyukinya");
+	EXPECT_EQ(message.body(), "Gr\xC3\xBC\xC3\x9F" "e");
+	EXPECT_EQ(message.text(), "Miyukinya: Gr\xC3\xBC\xC3\x9F" "e");
+
+	EXPECT_FALSE(ParseChatMessage(L"<quote>[&CGFMngACJRHqgbaVEDwNZJJNAGkAeQB1AGsAaQBuAHkAYQAAAA==]: ", message));
+	EXPECT_FALSE(ParseChatMessage(L"<quote>[&AgH1WQAA]: not a player link", message));
+	EXPECT_EQ(message.sender(), "Miyukinya");
+}
+
+}
@@ -0,0 +1,88 @@
+#include <ChatView.h>
+#include "HeadlessImGui.h"
+#include <gtest/gtest.h>
+
+namespace GW2Radial
+{
+
+struct FrameGeometry
+{
+	std::vector<ImDrawVert> vertices;
+	std::vector<ImDrawIdx> indices;
+	int commands = 0;
+};
+
+static FrameGeometry Geometry(const ImDrawData& frame)
+{
+	FrameGeometry geometry;
+	for (int i = 0; i < frame.CmdListsCount; i++)
+	{
+		const ImDrawList* list = frame.CmdLists[i];
+		geometry.vertices.insert(geometry.vertices.end(), list->VtxBuffer.begin(), list->VtxBuffer.end());
+		geometry.indices.insert(geometry.indices.end(), list->IdxBuffer.begin(), list->IdxBuffer.end());
+		geometry.commands += list->CmdBuffer.Size;
+	}
+	return geometry;
+}
+
+class ChatViewTest : public testing::Test
+{
+protected:
+	HeadlessImGui gui_;
+	ChatLog log_ { { 5000, 0, ~size_t(0) } };
+
+	void SetUp() override
+	{
+		FillChatLog(log_, 5000);
+	}
+
+	template<typename Content>
+	FrameGeometry Settled(float scrollY, Content&& content)
+	{
+		// The first frame only sizes the window and the second scrolls it
+		gui_.Frame(scrollY, content);
+		gui_.Frame(scrollY, content);
+		return Geometry(gui_.Frame(scrollY, content));
+	}
+};
+
+TEST_F(ChatViewTest, SameGeometryAsClippedTextUnformatted)
+{
+	for (const float scrollY : { 0.f, 12345.f, 1e9f })
+	{
+		const auto expected = Settled(scrollY, [&] { DrawClippedChatLines(log_); });
+		ChatView view;
+		const auto actual = Settled(scrollY, [&] { view.Draw(log_); });
+
+		ASSERT_GT(expected.vertices.size(), 1000u);
+		ASSERT_EQ(actual.vertices.size(), expected.vertices.size()) << "scrolled to " << scrollY;
+		for (size_t i = 0; i < actual.vertices.size(); i++)
+		{
+			const auto& a = actual.vertices[i];
+			const auto& e = expected.vertices[i];
+			ASSERT_TRUE(a.pos.x == e.pos.x && a.pos.y == e.pos.y && a.uv.x == e.uv.x && a.uv.y == e.uv.y && a.col == e.col)
+				<< "vertex " << i << " scrolled to " << scrollY;
+		}
+		EXPECT_EQ(actual.indices, expected.indices);
+		EXPECT_EQ(actual.commands, expected.commands);
+	}
+}
+
+TEST_F(ChatViewTest, VisibleLinesAreOnlyLaidOutOnce)
+{
+	ChatView view;
+	Settled(2000.f, [&] { view.Draw(log_); });
+	const auto misses = view.cacheMisses();
+	// A 400 pixel window shows a few dozen of the 5000 lines
+	EXPECT_GT(misses, 0u);
+	EXPECT_LT(misses, 100u);
+
+	gui_.Frame(2000.f, [&] { view.Draw(log_); });
+	EXPECT_EQ(view.cacheMisses(), misses);
+
+	view.Invalidate();
+	gui_.Frame(2000.f, [&] { view.Draw(log_); });
+	EXPECT_GT(view.cacheMisses(), misses);
+}
+
+}
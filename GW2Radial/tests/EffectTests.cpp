@@ -0,0 +1,261 @@
+#include <Effect.h>
+#include <InstancedQuad.h>
+#include <UnitQuad.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace GW2Radial
+{
+
+// How many registers of each kind the effect shadows and saves
+struct EffectRegisters : Effect
+{
+	static constexpr uint Count = ConstantRegisters::Count;
+};
+
+class EffectTest : public testing::Test
+{
+protected:
+	IDirect3DDevice9 device_;
+	UnitQuad quad_ { &device_ };
+	Effect fx_ { &device_ };
+
+	void SetUp() override
+	{
+		ASSERT_TRUE(fx_.Load());
+	}
+
+	// The variables a wheel sets before drawing its elements: 10 calls over 9 registers
+	void SetWheelVariables(float time)
+	{
+		fVector4 screenSize = { 1.f / 1920, 1.f / 1080, 1920.f, 1080.f };
+		fVector4 centerScale = { 0.5f, 0.5f, 0.25f, 0.f };
+		float hovers[4] = { 0.f, 1.f, 0.f, 0.f };
+
+		fx_.SetTechnique(EFF_TC_MOUNTIMAGE);
+		fx_.SetVector(EFF_VS_SCREEN_SIZE, &screenSize);
+		fx_.SetFloat(EFF_VS_ANIM_TIMER, time);
+		fx_.SetFloat(EFF_VS_WHEEL_FADEIN, 1.f);
+		fx_.SetVector(EFF_VS_CENTER_SCALE, &centerScale);
+		fx_.SetFloat(EFF_VS_ELEMENT_COUNT, 4.f);
+		fx_.SetFloatArray(EFF_VS_HOVER_FADEINS, hovers, 4);
+	}
+
+	uint uploadedRegisters() const
+	{
+		uint registers = 0;
+		for (const auto& u : device_.constantUploads)
+			registers += u.count;
+		return registers;
+	}
+};
+
+TEST_F(EffectTest, StateBlockRecordingUploadsNothing)
+{
+	EXPECT_TRUE(device_.constantUploads.empty());
+}
+
+TEST_F(EffectTest, CommitUploadsContiguousRuns)
+{
+	fx_.SceneBegin(&quad_);
+	SetWheelVariables(0.f);
+	fx_.BeginPass(0);
+
+	// Pixel shader registers 0-3 and 7-11; screen size has no register
+	ASSERT_EQ(device_.constantUploads.size(), 2u);
+	EXPECT_FALSE(device_.constantUploads[0].vertexShader);
+	EXPECT_EQ(device_.constantUploads[0].first, 0u);
+	EXPECT_EQ(device_.constantUploads[0].count, 4u);
+	EXPECT_EQ(device_.constantUploads[1].first, 7u);
+	EXPECT_EQ(device_.constantUploads[1].count, 5u);
+}
+
+TEST_F(EffectTest, UnchangedVariablesAreNotUploadedAgain)
+{
+	fx_.SceneBegin(&quad_);
+	SetWheelVariables(0.f);
+	fx_.BeginPass(0);
+	device_.constantUploads.clear();
+
+	SetWheelVariables(0.f);
+	fx_.CommitChanges();
+	EXPECT_TRUE(device_.constantUploads.empty());
+}
+
+TEST_F(EffectTest, OneChangedVariableUploadsOneRegister)
+{
+	fx_.SceneBegin(&quad_);
+	SetWheelVariables(0.f);
+	fx_.BeginPass(0);
+	device_.constantUploads.clear();
+
+	SetWheelVariables(0.5f);
+	fx_.CommitChanges();
+	ASSERT_EQ(device_.constantUploads.size(), 1u);
+	EXPECT_FALSE(device_.constantUploads[0].vertexShader);
+	EXPECT_EQ(device_.constantUploads[0].first, 0u);
+	EXPECT_EQ(device_.constantUploads[0].count, 1u);
+}
+
+TEST_F(EffectTest, ElementsOnlyUploadWhatDiffersFromThePreviousOne)
+{
+	fx_.SceneBegin(&quad_);
+	SetWheelVariables(0.f);
+	fx_.BeginPass(0);
+	device_.constantUploads.clear();
+
+	// Same sprite size and color for every element, only the uv rect and params move
+	for (int i = 0; i < 4; i++)
+	{
+		fVector4 spriteDim = { 0.1f, 0.1f, 0.f, 0.f };
+		fVector4 uvRect = { i * 0.25f, 0.f, 0.25f, 1.f };
+		fVector4 color = { 1.f, 1.f, 1.f, 1.f };
+		fVector4 params = { float(i), 0.f, 0.f, 0.f };
+		fx_.SetVector(EFF_VS_SPRITE_DIM, &spriteDim);
+		fx_.SetVector(EFF_VS_ELEMENT_UV_RECT, &uvRect);
+		fx_.SetVector(EFF_VS_ELEMENT_COLOR, &color);
+		fx_.SetVector(EFF_VS_ELEMENT_PARAMS, &params);
+		fx_.CommitChanges();
+	}
+
+	// The first element uploads vertex shader registers 0-3 at once, every later one 1 and 3
+	ASSERT_EQ(device_.constantUploads.size(), 1u + 3 * 2);
+	EXPECT_TRUE(device_.constantUploads[0].vertexShader);
+	EXPECT_EQ(device_.constantUploads[0].count, 4u);
+	EXPECT_EQ(uploadedRegisters(), 4u + 3 * 2);
+}
+
+TEST_F(EffectTest, NewSceneUploadsEverythingAgain)
+{
+	fx_.SceneBegin(&quad_);
+	SetWheelVariables(0.f);
+	fx_.BeginPass(0);
+	fx_.SceneEnd();
+	const auto firstFrame = uploadedRegisters();
+	device_.constantUploads.clear();
+
+	// The game may have overwritten the registers in between
+	fx_.SceneBegin(&quad_);
+	SetWheelVariables(0.f);
+	fx_.BeginPass(0);
+	EXPECT_EQ(uploadedRegisters(), firstFrame);
+	EXPECT_EQ(device_.uploadedBytes(), firstFrame * 4 * sizeof(float));
+}
+
+class EffectStateTest : public EffectTest
+{
+protected:
+	IDirect3DTexture9 gameTexture_, background_, ink_, atlas_;
+	IDirect3DPixelShader9 gamePixelShader_;
+	IDirect3DVertexShader9 gameVertexShader_;
+	InstancedQuad instances_ { &device_, 16 };
+
+	// What the game leaves behind: far more state than a wheel touches, but not all of it, so some of
+	// what the wheel sets has to go back to its default rather than to a value of the game's
+	void SetGameState()
+	{
+		for (DWORD rs = 7; rs <= 209; rs++)
+			device_.SetRenderState(D3DRENDERSTATETYPE(rs), rs * 3);
+		for (DWORD sampler = 0; sampler < 16; sampler++)
+			for (DWORD ss = 1; ss <= 13; ss++)
+				device_.SetSamplerState(sampler, D3DSAMPLERSTATETYPE(ss), sampler + ss);
+		for (DWORD stage = 0; stage < 8; stage++)
+			device_.SetTexture(stage, &gameTexture_);
+		device_.SetPixelShader(&gamePixelShader_);
+		device_.SetVertexShader(&gameVertexShader_);
+
+		D3DVIEWPORT9 vp = { 0, 0, 2560, 1440, 0.f, 1.f };
+		device_.SetViewport(&vp);
+
+		std::vector<float> constants(256 * 4, 0.5f);
+		device_.SetVertexShaderConstantF(0, constants.data(), 256);
+		device_.SetPixelShaderConstantF(0, constants.data(), 224);
+	}
+
+	// A wheel's frame as Wheel::Draw makes it: background, elements and cursor
+	void DrawWheel()
+	{
+		fx_.SceneBegin(&quad_);
+		D3DVIEWPORT9 vp = { 0, 0, 1920, 1080, 0.f, 1.f };
+		device_.SetViewport(&vp);
+
+		SetWheelVariables(0.f);
+		fx_.SetTexture(EFF_TS_BG, &background_);
+		fx_.SetTexture(EFF_TS_INK, &ink_);
+		fx_.BeginPass(0);
+		quad_.Draw();
+
+		fx_.SetTechnique(EFF_TC_MOUNTIMAGE_ALPHABLEND);
+		const std::vector<QuadInstance> data(4);
+		const std::vector<IDirect3DTexture9*> textures(4, &atlas_);
+		InstancedQuad::DrawAll(&fx_, quad_, &instances_, data.data(), textures.data(), 4);
+
+		fx_.SetTechnique(EFF_TC_CURSOR);
+		fx_.BeginPass(0);
+		quad_.Draw();
+	}
+};
+
+TEST_F(EffectStateTest, RecordedBlockRestoresWhatAnAllBlockWould)
+{
+	SetGameState();
+	IDirect3DStateBlock9* all = nullptr;
+	ASSERT_TRUE(SUCCEEDED(device_.CreateStateBlock(D3DSBT_ALL, &all)));
+	const auto gameState = device_.state;
+
+	// The frame changes the state, and applying everything the game had puts it back
+	DrawWheel();
+	EXPECT_NE(device_.state, gameState);
+	all->Apply();
+	EXPECT_EQ(device_.state, gameState);
+
+	// SceneEnd alone does the same with the recorded block
+	DrawWheel();
+	fx_.SceneEnd();
+	EXPECT_EQ(device_.state, gameState);
+
+	all->Release();
+}
+
+TEST_F(EffectStateTest, RecordedBlockCopiesOnlyWhatTheEffectTouches)
+{
+	SetGameState();
+	IDirect3DStateBlock9* all = nullptr;
+	ASSERT_TRUE(SUCCEEDED(device_.CreateStateBlock(D3DSBT_ALL, &all)));
+
+	// Render, sampler and texture stage states, two shaders, a declaration, two streams with their
+	// frequencies, indices, the viewport and both constant register files
+	const size_t touched = 8 + 15 + 3 + 2 + 1 + 2 * 2 + 1 + 1 + 2 * EffectRegisters::Count;
+
+	device_.copiedStates = 0;
+	DrawWheel();
+	fx_.SceneEnd();
+	EXPECT_EQ(device_.copiedStates, 2 * touched);
+
+	// Saving and restoring the whole device instead copies several times as much
+	device_.copiedStates = 0;
+	all->Capture();
+	all->Apply();
+	EXPECT_GT(device_.copiedStates, 4 * 2 * touched);
+
+	all->Release();
+}
+
+TEST_F(EffectStateTest, FrameCallCounts)
+{
+	SetGameState();
+	device_.calls.clear();
+	DrawWheel();
+	fx_.SceneEnd();
+
+	EXPECT_EQ(device_.calls["IDirect3DStateBlock9::Capture"], 1u);
+	EXPECT_EQ(device_.calls["IDirect3DStateBlock9::Apply"], 1u);
+	// The scene's six and two per technique
+	EXPECT_EQ(device_.calls["SetRenderState"], 6u + 3 * 2);
+	EXPECT_EQ(device_.calls["SetSamplerState"], 15u);
+	// The elements share one texture, so they are drawn in one call
+	EXPECT_EQ(device_.calls["SetTexture"], 3u);
+	EXPECT_EQ(device_.calls["DrawIndexedPrimitive"], 3u);
+}
+
+}
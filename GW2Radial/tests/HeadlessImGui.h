@@ -0,0 +1,89 @@
+#pragma once
+// ImGui without a renderer, as in imgui/examples/example_null: frames are only built, and their
+// draw lists left to the caller, so windows can be tested and benchmarked without a device.
+// Also holds the chat window's earlier drawing loops, which ChatView has to reproduce.
+#include <ChatLog.h>
+#include <imgui.h>
+#include <string>
+#include <vector>
+
+namespace GW2Radial
+{
+
+class HeadlessImGui
+{
+public:
+	HeadlessImGui()
+	{
+		context_ = ImGui::CreateContext();
+		ImGuiIO& io = ImGui::GetIO();
+		io.IniFilename = nullptr;
+
+		unsigned char* pixels;
+		int width, height;
+		io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+	}
+	~HeadlessImGui() { ImGui::DestroyContext(context_); }
+
+	// Builds a frame with a 600x400 chat window, submitting content to it and asking for scrollY,
+	// which ImGui clamps and applies on the next frame
+	template<typename Content>
+	const ImDrawData& Frame(float scrollY, Content&& content)
+	{
+		ImGuiIO& io = ImGui::GetIO();
+		io.DisplaySize = ImVec2(1920.f, 1080.f);
+		io.DeltaTime = 1.f / 60.f;
+		ImGui::NewFrame();
+
+		ImGui::SetNextWindowPos(ImVec2(100.f, 100.f));
+		ImGui::SetNextWindowSize(ImVec2(600.f, 400.f));
+		ImGui::Begin("ru chat", nullptr, ImGuiWindowFlags_NoSavedSettings);
+		content();
+		ImGui::SetScrollY(scrollY);
+		ImGui::End();
+
+		ImGui::Render();
+		return *ImGui::GetDrawData();
+	}
+
+protected:
+	ImGuiContext* context_;
+};
+
+// Chat lines from one sender, every seventh one long enough to run past the window's right edge
+inline void FillChatLog(ChatLog& log, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		std::wstring body = L"line " + std::to_wstring(i) + L": anyone up for the world boss train at the next spawn?";
+		if (i % 7 == 0)
+			body += std::wstring(120, L'~');
+		log.Append(L"<quote>[&CGFMngACJRHqgbaVEDwNZJJNAGkAeQB1AGsAaQBuAHkAYQAAAA==]: " + body, mstime(i));
+	}
+}
+
+// The chat window before ChatView, every retained line laid out every frame
+inline void DrawAllChatLines(const ChatLog& log)
+{
+	for (size_t i = 0; i < log.size(); i++)
+	{
+		const auto& text = log[i].text();
+		ImGui::TextUnformatted(text.c_str(), text.c_str() + text.size());
+	}
+}
+
+// Only the visible lines, each laid out by ImGui every frame
+inline void DrawClippedChatLines(const ChatLog& log)
+{
+	ImGuiListClipper clipper(int(log.size()), ImGui::GetTextLineHeightWithSpacing());
+	while (clipper.Step())
+	{
+		for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
+		{
+			const auto& text = log[i].text();
+			ImGui::TextUnformatted(text.c_str(), text.c_str() + text.size());
+		}
+	}
+}
+
+}
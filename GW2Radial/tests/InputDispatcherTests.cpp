@@ -0,0 +1,140 @@
+#include <InputDispatcher.h>
+#include <Main.h>
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+// Counts allocations made on the current thread, so the test can show dispatching does none.
+// Replacing the global operator new applies to the whole test binary, but only adds a counter.
+static thread_local size_t AllocationCount = 0;
+
+void* operator new(size_t size)
+{
+	AllocationCount++;
+	if (void* p = std::malloc(size ? size : 1))
+		return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	std::free(p);
+}
+
+namespace GW2Radial
+{
+
+static intptr_t KeyLParam(uint scancode, bool extended = false, bool alt = false)
+{
+	return intptr_t((scancode << 16) | (extended ? 0x01000000 : 0) | (alt ? 0x20000000 : 0));
+}
+
+TEST(InputDispatcher, TranslatesKeysAndButtons)
+{
+	auto keys = InputDispatcher::Translate(WM_KEYDOWN, 'A', KeyLParam(0x1E), false);
+	ASSERT_EQ(keys.size(), 1u);
+	EXPECT_EQ(keys.begin()->vk, uint('A'));
+	EXPECT_TRUE(keys.begin()->down);
+
+	keys = InputDispatcher::Translate(WM_XBUTTONUP, uintptr_t(XBUTTON2) << 16, 0, false);
+	ASSERT_EQ(keys.size(), 1u);
+	EXPECT_EQ(keys.begin()->vk, uint(VK_XBUTTON2));
+	EXPECT_FALSE(keys.begin()->down);
+
+	EXPECT_TRUE(InputDispatcher::Translate(WM_MOUSEMOVE, 0, 0, false).empty());
+	EXPECT_TRUE(InputDispatcher::Translate(WM_CHAR, 'a', 0, false).empty());
+}
+
+TEST(InputDispatcher, SplitsModifiersIntoLeftAndRight)
+{
+	EXPECT_EQ(InputDispatcher::Translate(WM_KEYDOWN, VK_SHIFT, KeyLParam(0x2A), true).begin()->vk, uint(VK_LSHIFT));
+	EXPECT_EQ(InputDispatcher::Translate(WM_KEYDOWN, VK_SHIFT, KeyLParam(0x36), true).begin()->vk, uint(VK_RSHIFT));
+	EXPECT_EQ(InputDispatcher::Translate(WM_KEYDOWN, VK_CONTROL, KeyLParam(0x1D, true), true).begin()->vk, uint(VK_RCONTROL));
+	EXPECT_EQ(InputDispatcher::Translate(WM_KEYDOWN, VK_CONTROL, KeyLParam(0x1D, true), false).begin()->vk, uint(VK_CONTROL));
+}
+
+TEST(InputDispatcher, SystemKeysReportContextCode)
+{
+	// A system key release while Alt is held first reports the key as down, as Input always has
+	const auto keys = InputDispatcher::Translate(WM_SYSKEYUP, 'Q', KeyLParam(0x10, false, true), false);
+	ASSERT_EQ(keys.size(), 2u);
+	EXPECT_EQ(keys.begin()[0].vk, uint('Q'));
+	EXPECT_TRUE(keys.begin()[0].down);
+	EXPECT_EQ(keys.begin()[1].vk, uint('Q'));
+	EXPECT_FALSE(keys.begin()[1].down);
+
+	// F10 arrives as a system key without Alt being involved
+	EXPECT_EQ(InputDispatcher::Translate(WM_SYSKEYDOWN, VK_F10, KeyLParam(0x44), false).size(), 1u);
+}
+
+TEST(InputDispatcher, TracksHeldKeysAndCombinesResponses)
+{
+	InputDispatcher dispatcher;
+	std::vector<bool> changes;
+	InputDispatcher::InputChangeCallback passes = [&](bool changed, const KeyCombo&, const EventKeys&) { changes.push_back(changed); return InputResponse::PASS_TO_GAME; };
+	InputDispatcher::InputChangeCallback blocksQ = [](bool, const KeyCombo& keys, const EventKeys&) { return keys.count('Q') ? InputResponse::PREVENT_ALL : InputResponse::PASS_TO_GAME; };
+	InputDispatcher::MouseMoveCallback blocksMouse = [] { return true; };
+	dispatcher.AddInputChangeCallback(&passes);
+	dispatcher.AddInputChangeCallback(&blocksQ);
+
+	EXPECT_FALSE(dispatcher.wantsMouseMoves());
+	EXPECT_EQ(dispatcher.Dispatch(InputDispatcher::Translate(WM_KEYDOWN, 'Q', 0, false), false), InputResponse::PREVENT_ALL);
+	EXPECT_EQ(dispatcher.Dispatch(InputDispatcher::Translate(WM_KEYDOWN, 'Q', 0, false), false), InputResponse::PREVENT_ALL);
+	EXPECT_EQ(dispatcher.Dispatch(InputDispatcher::Translate(WM_KEYUP, 'Q', 0, false), false), InputResponse::PASS_TO_GAME);
+	EXPECT_EQ(changes, (std::vector<bool> { true, false, true }));
+	EXPECT_TRUE(dispatcher.downKeys().empty());
+
+	// Mouse moves carry no key events, so only the mouse callbacks see them
+	dispatcher.AddMouseMoveCallback(&blocksMouse);
+	EXPECT_TRUE(dispatcher.wantsMouseMoves());
+	EXPECT_EQ(dispatcher.Dispatch(EventKeys(), true), InputResponse::PREVENT_MOUSE);
+	EXPECT_EQ(changes.size(), 3u);
+
+	dispatcher.RemoveMouseMoveCallback(&blocksMouse);
+	dispatcher.RemoveInputChangeCallback(&blocksQ);
+	EXPECT_EQ(dispatcher.Dispatch(InputDispatcher::Translate(WM_LBUTTONDOWN, 0, 0, false), true), InputResponse::PASS_TO_GAME);
+	EXPECT_EQ(dispatcher.downKeys(), KeyCombo({ VK_LBUTTON }));
+	dispatcher.ClearDownKeys();
+	EXPECT_TRUE(dispatcher.downKeys().empty());
+}
+
+TEST(InputDispatcher, HandlingMessagesDoesNotAllocate)
+{
+	struct Message
+	{
+		uint msg;
+		uintptr_t wParam;
+		intptr_t lParam;
+	};
+	const std::vector<Message> messages {
+		{ WM_KEYDOWN, VK_SHIFT, KeyLParam(0x2A) },
+		{ WM_SYSKEYDOWN, 'Q', KeyLParam(0x10, false, true) },
+		{ WM_MOUSEMOVE, 0, 0 },
+		{ WM_XBUTTONDOWN, uintptr_t(XBUTTON1) << 16, 0 },
+		{ WM_SYSKEYUP, 'Q', KeyLParam(0x10, false, true) },
+		{ WM_XBUTTONUP, uintptr_t(XBUTTON1) << 16, 0 },
+		{ WM_KEYUP, VK_SHIFT, KeyLParam(0x2A) },
+	};
+
+	InputDispatcher dispatcher;
+	size_t events = 0;
+	InputDispatcher::InputChangeCallback counts = [&](bool, const KeyCombo& keys, const EventKeys& changed) { events += changed.size() + keys.size(); return InputResponse::PASS_TO_GAME; };
+	InputDispatcher::MouseMoveCallback moves = [] { return false; };
+	dispatcher.AddInputChangeCallback(&counts);
+	dispatcher.AddMouseMoveCallback(&moves);
+
+	const size_t before = AllocationCount;
+	for (int i = 0; i < 1000; i++)
+		for (const auto& m : messages)
+			dispatcher.Dispatch(InputDispatcher::Translate(m.msg, m.wParam, m.lParam, true), m.msg == WM_MOUSEMOVE);
+	EXPECT_EQ(AllocationCount, before);
+	EXPECT_GT(events, 0u);
+}
+
+}
@@ -0,0 +1,189 @@
+#include <InputReplay.h>
+#include <Main.h>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <numeric>
+#include <thread>
+
+namespace GW2Radial
+{
+
+static InputRecord KeyRecord(uint64_t ms, uint msg, uint vk, uint32_t flags = 0)
+{
+	return { ms * 1000, msg, flags, vk, 0 };
+}
+
+TEST(InputReplay, LoadsWhatTheRecorderWrites)
+{
+	const std::vector<InputRecord> written { KeyRecord(0, WM_KEYDOWN, 'A'), KeyRecord(5, WM_KEYUP, 'A') };
+
+	FILE* fp = tmpfile();
+	ASSERT_NE(fp, nullptr);
+	const RecordingHeader header { { 'G', 'R', 'I', 'R' }, RecordingHeader::Version };
+	fwrite(&header, sizeof(header), 1, fp);
+	fwrite(written.data(), sizeof(InputRecord), written.size(), fp);
+	rewind(fp);
+
+	std::vector<InputRecord> read;
+	EXPECT_TRUE(InputReplay::Load(fp, read));
+	ASSERT_EQ(read.size(), written.size());
+	EXPECT_EQ(read[1].time, 5000u);
+	EXPECT_EQ(read[1].msg, uint(WM_KEYUP));
+
+	rewind(fp);
+	fputs("not a recording", fp);
+	rewind(fp);
+	EXPECT_FALSE(InputReplay::Load(fp, read));
+	fclose(fp);
+}
+
+TEST(InputReplay, CallbacksSeeSimulatedTimeAndSendNothing)
+{
+	InputReplay replay(false);
+
+	// Stands in for a wheel sending its element's keybind once its own is released
+	std::vector<int64_t> seen;
+	InputDispatcher::InputChangeCallback wheel = [&](bool changed, const KeyCombo& keys, const EventKeys& changedKeys)
+	{
+		seen.push_back(replay.clock().ticks());
+		for (const auto& k : changedKeys)
+			if (changed && !k.down && k.vk == 'Q')
+				replay.SendKeybind({ VK_LSHIFT, '1' });
+		return keys.count('Q') ? InputResponse::PREVENT_ALL : InputResponse::PASS_TO_GAME;
+	};
+	replay.dispatcher().AddInputChangeCallback(&wheel);
+
+	const std::vector<InputRecord> records {
+		KeyRecord(100, WM_KEYDOWN, 'Q'),
+		KeyRecord(130, WM_MOUSEMOVE, 0),
+		KeyRecord(150, WM_KEYDOWN, '1', InputRecord::Synthetic),
+		KeyRecord(400, WM_KEYUP, 'Q'),
+	};
+	const auto report = replay.Run(records);
+
+	EXPECT_TRUE(report.error.empty());
+	EXPECT_EQ(report.messages, 3u);
+	EXPECT_EQ(report.recordedSynthetic, 1u);
+	EXPECT_EQ(std::accumulate(report.histogram.begin(), report.histogram.end(), size_t(0)), 3u);
+	EXPECT_LE(report.p50, report.max);
+	EXPECT_EQ(seen, (std::vector<int64_t> { 100000, 400000 }));
+
+	// Shift first and last, as Input::SendKeybind would type it, starting 10 ms after the release
+	ASSERT_EQ(report.sentKeys.size(), 4u);
+	const uint keys[] = { VK_LSHIFT, '1', '1', VK_LSHIFT };
+	const bool down[] = { true, true, false, false };
+	const mstime times[] = { 410, 430, 500, 520 };
+	for (size_t i = 0; i < 4; i++)
+	{
+		EXPECT_EQ(report.sentKeys[i].vk, keys[i]);
+		EXPECT_EQ(report.sentKeys[i].down, down[i]);
+		EXPECT_EQ(report.sentKeys[i].time, times[i]);
+	}
+	EXPECT_TRUE(replay.dispatcher().downKeys().empty());
+}
+
+TEST(InputReplay, HeldKeysAreNotSentAndFocusLossReleasesThem)
+{
+	InputReplay replay(true);
+
+	KeyCombo heldOnSend;
+	InputDispatcher::InputChangeCallback sendOnE = [&](bool changed, const KeyCombo& keys, const EventKeys&)
+	{
+		if (changed && keys.count('E'))
+		{
+			heldOnSend = keys;
+			replay.SendKeybind({ VK_LSHIFT, 'R' });
+		}
+		return InputResponse::PASS_TO_GAME;
+	};
+	replay.dispatcher().AddInputChangeCallback(&sendOnE);
+
+	const auto report = replay.Run({
+		{ 0, WM_KEYDOWN, 0, VK_SHIFT, 0x2A << 16 },
+		KeyRecord(10, WM_KEYDOWN, 'E'),
+		KeyRecord(20, WM_KILLFOCUS, 0),
+		KeyRecord(30, WM_KEYDOWN, 'E'),
+	});
+
+	EXPECT_EQ(report.messages, 3u);
+	EXPECT_EQ(heldOnSend, KeyCombo({ 'E' }));
+	// The first send leaves the held left Shift alone; the second comes after focus loss released it
+	ASSERT_EQ(report.sentKeys.size(), 6u);
+	EXPECT_EQ(report.sentKeys[0].vk, uint('R'));
+	EXPECT_EQ(report.sentKeys[0].time, 20u);
+	EXPECT_EQ(report.sentKeys[2].vk, uint(VK_LSHIFT));
+	EXPECT_EQ(report.sentKeys[2].time, 40u);
+}
+
+// What Input::Replay sets up: the live dispatcher's callbacks, run on keys of the replay's own, and a
+// keybind sender which finds the replay through running(), as Input::SendKeybind does
+TEST(InputReplay, RunsTheLiveCallbacksOnItsOwnKeys)
+{
+	InputDispatcher live;
+	std::vector<mstime> sendTimes;
+	InputDispatcher::InputChangeCallback wheel = [&](bool changed, const KeyCombo& keys, const EventKeys& changedKeys)
+	{
+		for (const auto& k : changedKeys)
+		{
+			if (changed && !k.down && k.vk == 'Q')
+			{
+				sendTimes.push_back(TimeInMilliseconds());
+				if (auto* replay = InputReplay::running())
+					replay->SendKeybind({ '1' });
+			}
+		}
+		return InputResponse::PASS_TO_GAME;
+	};
+	live.AddInputChangeCallback(&wheel);
+	live.Dispatch(InputDispatcher::Translate(WM_KEYDOWN, 'E', 0, false), false);
+
+	InputReplay replay(false);
+	replay.dispatcher().AddCallbacks(live);
+	const auto report = replay.Run({ KeyRecord(250, WM_KEYDOWN, 'Q'), KeyRecord(300, WM_KEYUP, 'Q') });
+
+	// The callback read the simulated time through the ordinary clock
+	EXPECT_EQ(sendTimes, std::vector<mstime> { 300 });
+	ASSERT_EQ(report.sentKeys.size(), 2u);
+	EXPECT_EQ(report.sentKeys[0].time, 310u);
+	EXPECT_EQ(live.downKeys(), KeyCombo({ 'E' }));
+
+	// Outside the replay, time is real again and keybinds would really be sent
+	EXPECT_EQ(InputReplay::running(), nullptr);
+	EXPECT_EQ(&Clock::source(), &Clock::system());
+}
+
+TEST(InputReplay, CallbacksRunUnderTheDispatchLock)
+{
+	std::mutex dispatchLock;
+	size_t calls = 0, lockedOut = 0;
+	InputDispatcher::InputChangeCallback callback = [&](bool, const KeyCombo&, const EventKeys&)
+	{
+		calls++;
+		// Stands in for the window thread taking the lock for live input
+		bool acquired = false;
+		std::thread([&] { acquired = dispatchLock.try_lock(); if (acquired) dispatchLock.unlock(); }).join();
+		lockedOut += !acquired;
+		return InputResponse::PASS_TO_GAME;
+	};
+
+	InputReplay replay(false);
+	replay.dispatcher().AddInputChangeCallback(&callback);
+	replay.Run({ KeyRecord(0, WM_KEYDOWN, 'A'), KeyRecord(10, WM_KEYUP, 'A') }, &dispatchLock);
+
+	EXPECT_EQ(calls, 2u);
+	EXPECT_EQ(lockedOut, 2u);
+	EXPECT_TRUE(dispatchLock.try_lock());
+	dispatchLock.unlock();
+}
+
+TEST(InputReplay, OnlyReplayableMessagesAreRecorded)
+{
+	for (uint msg : { WM_KEYDOWN, WM_SYSKEYUP, WM_LBUTTONDOWN, WM_XBUTTONUP, WM_MOUSEMOVE, WM_KILLFOCUS })
+		EXPECT_TRUE(InputReplay::Replayable(msg)) << msg;
+
+	// Typed text, and raw input whose handles are gone by replay time
+	EXPECT_FALSE(InputReplay::Replayable(WM_CHAR));
+	EXPECT_FALSE(InputReplay::Replayable(WM_INPUT));
+}
+
+}
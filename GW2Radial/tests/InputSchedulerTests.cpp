@@ -0,0 +1,164 @@
+#include <InputScheduler.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <random>
+#include <vector>
+
+namespace GW2Radial
+{
+
+// Steady clock time rescaled to the ACPI timer's 3.579545 MHz, a rate which is not a whole number of
+// 100 ns timer units per tick, so deadlines only come out right if they are converted correctly
+class AcpiRateClock : public ClockSource
+{
+public:
+	int64_t ticks() const override
+	{
+		const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+		return Clock::Convert(ns, 1000000000, ticksPerSecond());
+	}
+	int64_t ticksPerSecond() const override { return 3579545; }
+
+protected:
+	const std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+};
+
+// The ACPI rate again, but only moving when the test advances it
+class ManualAcpiClock : public ClockSource
+{
+public:
+	int64_t ticks() const override { return ticks_.load(); }
+	int64_t ticksPerSecond() const override { return 3579545; }
+
+	void Advance(int64_t ticks) { ticks_ += ticks; }
+
+protected:
+	std::atomic<int64_t> ticks_ { 1000000 };
+};
+
+// How far a timer waiting this many 100 ns units moves a clock, rounded up to whole ticks
+static int64_t TimerUnitsToTicks(const ClockSource& clock, int64_t units)
+{
+	const auto ticks = Clock::Convert(units, 10000000, clock.ticksPerSecond());
+	return Clock::Convert(ticks, clock.ticksPerSecond(), 10000000) < units ? ticks + 1 : ticks;
+}
+
+struct Sent
+{
+	InputScheduler::Message message;
+	int64_t at;
+};
+
+// Collects what the scheduler sends, with the clock reading at the time
+class SentLog
+{
+public:
+	explicit SentLog(const ClockSource& clock) : clock_(clock) { }
+
+	InputScheduler::Sender sender()
+	{
+		return [this](const InputScheduler::Message& m)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			sent_.push_back({ m, clock_.ticks() });
+			cv_.notify_all();
+		};
+	}
+
+	std::vector<Sent> WaitFor(size_t count)
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		cv_.wait_for(lock, std::chrono::seconds(10), [&] { return sent_.size() >= count; });
+		return sent_;
+	}
+
+protected:
+	const ClockSource& clock_;
+	std::mutex mutex_;
+	std::condition_variable cv_;
+	std::vector<Sent> sent_;
+};
+
+static int64_t Ms(const ClockSource& clock, int64_t ms)
+{
+	return Clock::Convert(ms, 1000, clock.ticksPerSecond());
+}
+
+TEST(InputScheduler, SendsInDeadlineThenSchedulingOrder)
+{
+	AcpiRateClock clock;
+	SentLog log(clock);
+	InputScheduler scheduler(clock, log.sender());
+
+	const auto start = clock.ticks();
+	scheduler.Schedule({ nullptr, 3, 0, 0, start + Ms(clock, 30) });
+	scheduler.Schedule({ nullptr, 1, 0, 0, start + Ms(clock, 10) });
+	scheduler.Schedule({ nullptr, 2, 0, 0, start + Ms(clock, 10) });
+	scheduler.Schedule({ nullptr, 0, 0, 0, start });
+
+	const auto sent = log.WaitFor(4);
+	ASSERT_EQ(sent.size(), 4u);
+	for (uint i = 0; i < 4; i++)
+		EXPECT_EQ(sent[i].message.msg, i);
+	EXPECT_TRUE(scheduler.empty());
+}
+
+TEST(InputScheduler, ClearDropsPendingMessages)
+{
+	AcpiRateClock clock;
+	SentLog log(clock);
+	InputScheduler scheduler(clock, log.sender());
+
+	scheduler.Schedule({ nullptr, 1, 0, 0, clock.ticks() + Ms(clock, 60000) });
+	EXPECT_FALSE(scheduler.empty());
+	scheduler.Clear();
+	EXPECT_TRUE(scheduler.empty());
+}
+
+TEST(InputScheduler, DeadlineErrorUnderNonNativeClock)
+{
+	ManualAcpiClock clock;
+	SentLog log(clock);
+	InputScheduler scheduler(clock, log.sender());
+
+	// Keybinds are sent as steps of tens of milliseconds, so a few odd offsets in that range
+	std::mt19937 rng(14);
+	std::uniform_int_distribution<int64_t> offset(Ms(clock, 1), Ms(clock, 40));
+	std::vector<int64_t> deadlines;
+	for (uint i = 0; i < 40; i++)
+	{
+		deadlines.push_back(clock.ticks() + offset(rng));
+		scheduler.Schedule({ nullptr, i, 0, 0, deadlines.back() });
+	}
+
+	// Lets exactly as much time pass as the scheduler asks its timer to wait each time, which is what a
+	// timer with perfect resolution would do. The scheduler thread may send a message before this loop
+	// gets to it, but never at another clock reading.
+	int steps = 0;
+	for (int64_t delay; (delay = scheduler.SendDue()) >= 0; steps++)
+	{
+		ASSERT_GT(delay, 0);
+		ASSERT_LT(steps, 1000) << "the scheduler keeps asking for waits which do not reach a deadline";
+		clock.Advance(TimerUnitsToTicks(clock, delay));
+	}
+
+	const auto sent = log.WaitFor(deadlines.size());
+	ASSERT_EQ(sent.size(), deadlines.size());
+
+	// One step per distinct deadline, none wasted on a wait rounded down
+	std::sort(deadlines.begin(), deadlines.end());
+	EXPECT_EQ(steps, std::unique(deadlines.begin(), deadlines.end()) - deadlines.begin());
+
+	// A wait is rounded up to whole 100 ns units and the clock advanced to the next whole tick after it
+	const int64_t bound = TimerUnitsToTicks(clock, 1) + 1;
+	for (const auto& s : sent)
+	{
+		EXPECT_GE(s.at, s.message.due) << "message " << s.message.msg;
+		EXPECT_LE(s.at - s.message.due, bound) << "message " << s.message.msg;
+	}
+}
+
+}
@@ -0,0 +1,113 @@
+#include <InstancedQuad.h>
+#include <UnitQuad.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+namespace GW2Radial
+{
+
+// Loaded like the real effect, but without the instanced vertex shader, as on devices where it fails to load
+class NonInstancingEffect : public Effect
+{
+public:
+	using Effect::Effect;
+	bool instancing() const override { return false; }
+};
+
+class InstancedQuadTest : public testing::Test
+{
+protected:
+	IDirect3DDevice9 device_;
+	UnitQuad quad_ { &device_ };
+	IDirect3DTexture9 atlas_, other_;
+
+	// Wheels have between 1 and a few dozen elements
+	std::vector<QuadInstance> Instances(uint count)
+	{
+		std::vector<QuadInstance> instances(count);
+		for (uint i = 0; i < count; i++)
+			instances[i].params = { float(i), 0.f, 0.f, 0.f };
+		return instances;
+	}
+
+	void Draw(Effect& fx, InstancedQuad* instances, const std::vector<IDirect3DTexture9*>& textures)
+	{
+		const auto data = Instances(uint(textures.size()));
+		fx.SceneBegin(&quad_);
+		InstancedQuad::DrawAll(&fx, quad_, instances, data.data(), textures.data(), uint(textures.size()));
+		fx.SceneEnd();
+	}
+};
+
+TEST_F(InstancedQuadTest, OneDrawCallRegardlessOfElementCount)
+{
+	Effect fx(&device_);
+	ASSERT_TRUE(fx.Load());
+	ASSERT_TRUE(fx.instancing());
+	InstancedQuad instances(&device_, 64);
+
+	for (uint count : { 1u, 4u, 12u, 64u })
+	{
+		device_.drawInstanceCounts.clear();
+		Draw(fx, &instances, std::vector<IDirect3DTexture9*>(count, &atlas_));
+
+		ASSERT_EQ(device_.drawInstanceCounts.size(), 1u) << count << " elements";
+		EXPECT_EQ(device_.drawInstanceCounts[0], count);
+	}
+}
+
+TEST_F(InstancedQuadTest, OneDrawCallPerRunOfTextures)
+{
+	Effect fx(&device_);
+	ASSERT_TRUE(fx.Load());
+	InstancedQuad instances(&device_, 16);
+
+	Draw(fx, &instances, { &atlas_, &atlas_, &atlas_, &other_, &atlas_, &atlas_ });
+	EXPECT_EQ(device_.drawInstanceCounts, (std::vector<UINT> { 3, 1, 2 }));
+}
+
+TEST_F(InstancedQuadTest, FallsBackToOneDrawPerElement)
+{
+	NonInstancingEffect fx(&device_);
+	ASSERT_TRUE(fx.Load());
+	InstancedQuad instances(&device_, 16);
+
+	Draw(fx, &instances, std::vector<IDirect3DTexture9*>(12, &atlas_));
+	EXPECT_EQ(device_.drawInstanceCounts, std::vector<UINT>(12, 1));
+}
+
+TEST_F(InstancedQuadTest, ElementsBeyondCapacityFallBack)
+{
+	Effect fx(&device_);
+	ASSERT_TRUE(fx.Load());
+	InstancedQuad instances(&device_, 4);
+
+	Draw(fx, &instances, std::vector<IDirect3DTexture9*>(6, &atlas_));
+	EXPECT_EQ(device_.drawInstanceCounts, std::vector<UINT>(6, 1));
+}
+
+TEST_F(InstancedQuadTest, PlainDrawsAfterInstancingAreNotInstanced)
+{
+	Effect fx(&device_);
+	ASSERT_TRUE(fx.Load());
+	InstancedQuad instances(&device_, 16);
+
+	Draw(fx, &instances, std::vector<IDirect3DTexture9*>(8, &atlas_));
+	device_.drawInstanceCounts.clear();
+
+	quad_.Draw();
+	EXPECT_EQ(device_.drawInstanceCounts, std::vector<UINT> { 1 });
+}
+
+TEST_F(InstancedQuadTest, DestroyingReleasesTheDefaultPoolBuffer)
+{
+	const auto before = device_.defaultPoolBuffers;
+	auto instances = std::make_unique<InstancedQuad>(&device_, 16);
+	EXPECT_EQ(device_.defaultPoolBuffers, before + 1);
+
+	instances.reset();
+	EXPECT_EQ(device_.defaultPoolBuffers, before);
+}
+
+}
@@ -0,0 +1,116 @@
+#include <KeyCombo.h>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+
+namespace GW2Radial
+{
+
+// Straightforward reading of the configuration format to hold Parse to: entries split on commas,
+// blanks trimmed, and anything but a plain decimal number below KeyCount is an error
+static size_t ReferenceParse(const std::string& text, KeyCombo& keys)
+{
+	keys.clear();
+	if (text.find_first_not_of(" \t") == std::string::npos)
+		return std::string::npos;
+
+	size_t firstError = std::string::npos;
+	size_t begin = 0;
+	while (true)
+	{
+		const size_t comma = std::min(text.find(',', begin), text.size());
+		size_t first = begin, last = comma;
+		while (first < last && (text[first] == ' ' || text[first] == '\t'))
+			first++;
+		while (last > first && (text[last - 1] == ' ' || text[last - 1] == '\t'))
+			last--;
+
+		const auto entry = text.substr(first, last - first);
+		const bool digits = !entry.empty() && entry.find_first_not_of("0123456789") == std::string::npos;
+		uint64_t value = 0;
+		for (size_t k = 0; digits && k < entry.size() && value < KeyCombo::KeyCount; k++)
+			value = value * 10 + uint(entry[k] - '0');
+		if (digits && value < KeyCombo::KeyCount)
+			keys.insert(uint(value));
+		else if (firstError == std::string::npos)
+			firstError = first;
+
+		if (comma == text.size())
+			return firstError;
+		begin = comma + 1;
+	}
+}
+
+TEST(KeyCombo, SerializeRoundTrips)
+{
+	std::mt19937 rng(20);
+	std::uniform_int_distribution<uint> key(0, KeyCombo::KeyCount - 1);
+	std::uniform_int_distribution<size_t> size(0, 12);
+
+	KeyCombo::SerializedBuffer buffer;
+	for (int i = 0; i < 5000; i++)
+	{
+		KeyCombo keys;
+		for (size_t n = size(rng); n > 0; n--)
+			keys.insert(key(rng));
+
+		const auto text = keys.Serialize(buffer);
+		KeyCombo parsed { 1, 2, 3 };
+		EXPECT_EQ(KeyCombo::Parse(text, parsed), std::string_view::npos) << text;
+		EXPECT_EQ(parsed, keys) << text;
+	}
+
+	// The buffer is sized for every key at once
+	KeyCombo all;
+	for (uint vk = 0; vk < KeyCombo::KeyCount; vk++)
+		all.insert(vk);
+	const auto text = all.Serialize(buffer);
+	EXPECT_LE(text.size(), KeyCombo::MaxSerializedLength);
+	KeyCombo parsed;
+	EXPECT_EQ(KeyCombo::Parse(text, parsed), std::string_view::npos);
+	EXPECT_EQ(parsed, all);
+}
+
+TEST(KeyCombo, ParseFuzzMatchesReference)
+{
+	std::mt19937 rng(21);
+	// Mostly the characters the format is made of, so inputs come close to valid ones
+	static const char alphabet[] = "0123456789012345678901234567890123456789,,,,  \t-+x.\xff";
+	std::uniform_int_distribution<size_t> pick(0, sizeof(alphabet) - 2), length(0, 40), anyByte(0, 255), mode(0, 9);
+
+	KeyCombo::SerializedBuffer buffer;
+	for (int i = 0; i < 50000; i++)
+	{
+		std::string text(length(rng), '\0');
+		for (auto& c : text)
+			c = mode(rng) == 0 ? char(anyByte(rng)) : alphabet[pick(rng)];
+
+		KeyCombo parsed, expected;
+		const auto error = KeyCombo::Parse(text, parsed);
+		EXPECT_EQ(error, ReferenceParse(text, expected)) << '"' << text << '"';
+		EXPECT_EQ(parsed, expected) << '"' << text << '"';
+
+		// Whatever was read back is stored cleanly
+		KeyCombo reparsed;
+		EXPECT_EQ(KeyCombo::Parse(parsed.Serialize(buffer), reparsed), std::string_view::npos);
+		EXPECT_EQ(reparsed, parsed);
+	}
+}
+
+TEST(KeyCombo, ParseKeepsValidEntries)
+{
+	KeyCombo keys;
+	EXPECT_EQ(KeyCombo::Parse("17, 65", keys), std::string_view::npos);
+	EXPECT_EQ(keys, KeyCombo({ 17, 65 }));
+
+	EXPECT_EQ(KeyCombo::Parse(" 17 ,\t65 ,", keys), 10u);
+	EXPECT_EQ(keys, KeyCombo({ 17, 65 }));
+
+	EXPECT_EQ(KeyCombo::Parse("17, 256, -1, 0x41, 65", keys), 4u);
+	EXPECT_EQ(keys, KeyCombo({ 17, 65 }));
+
+	EXPECT_EQ(KeyCombo::Parse(" \t ", keys), std::string_view::npos);
+	EXPECT_TRUE(keys.empty());
+}
+
+}
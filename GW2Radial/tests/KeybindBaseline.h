@@ -0,0 +1,116 @@
+#pragma once
+// Keybind matching as it was before KeyCombo and the keybind index: std::set<uint> keys, and conflicts
+// found by scanning every registered keybind. Kept to check the new code against and to benchmark it.
+#include <Main.h>
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace GW2Radial::Baseline
+{
+
+using KeySet = std::set<uint>;
+
+// Keybind::keys(const char*) reading a configuration value
+inline KeySet ParseKeys(const char* text)
+{
+	KeySet keys;
+	if (strnlen(text, 256) > 0)
+	{
+		std::stringstream ss(text);
+		while (ss.good())
+		{
+			std::string substr;
+			std::getline(ss, substr, ',');
+			keys.insert(static_cast<uint>(std::stoi(substr)));
+		}
+	}
+	return keys;
+}
+
+// Keybind::ApplyKeys writing one back
+inline std::string SerializeKeys(const KeySet& keys)
+{
+	std::string settingValue;
+	for (const auto& k : keys)
+		settingValue += std::to_string(k) + ", ";
+
+	if (!keys.empty())
+		settingValue = settingValue.substr(0, settingValue.size() - 2);
+	return settingValue;
+}
+
+class SetKeybindRegistry
+{
+public:
+	size_t Add(KeySet keys) { keys_.push_back(std::move(keys)); return keys_.size() - 1; }
+	// An emptied keybind neither conflicts nor shadows, so it stands in for a removed one
+	void Set(size_t kb, KeySet keys) { keys_[kb] = std::move(keys); }
+	const KeySet& keys(size_t kb) const { return keys_[kb]; }
+	size_t size() const { return keys_.size(); }
+
+	bool matches(size_t kb, const KeySet& pressedKeys) const { return pressedKeys == keys_[kb]; }
+
+	bool matchesPartial(size_t kb, const KeySet& pressedKeys) const
+	{
+		return !keys_[kb].empty() && std::includes(pressedKeys.begin(), pressedKeys.end(), keys_[kb].begin(), keys_[kb].end());
+	}
+
+	bool conflicts(size_t kb, const KeySet& pressedKeys) const
+	{
+		for (size_t other = 0; other < keys_.size(); other++)
+		{
+			if (other != kb && keys_[kb].size() < keys_[other].size()
+				&& std::includes(pressedKeys.begin(), pressedKeys.end(), keys_[other].begin(), keys_[other].end()))
+				return true;
+		}
+
+		return false;
+	}
+
+	bool matchesNoLeftRight(size_t kb, const KeySet& pressedKeys) const
+	{
+		auto k2 = pressedKeys;
+		const auto rep = [&](uint vk, uint vkr)
+		{
+			if (const auto k = k2.find(vk); k != k2.end())
+			{
+				k2.erase(k);
+				k2.insert(vkr);
+			}
+		};
+		rep(VK_LCONTROL, VK_CONTROL);
+		rep(VK_RCONTROL, VK_CONTROL);
+		rep(VK_LSHIFT, VK_SHIFT);
+		rep(VK_RSHIFT, VK_SHIFT);
+		rep(VK_LMENU, VK_MENU);
+		rep(VK_RMENU, VK_MENU);
+
+		return k2 == keys_[kb];
+	}
+
+	// Keybind::CheckForConflict(true), run whenever any keybind changed: every keybind against every other
+	std::vector<bool> conflicted() const
+	{
+		std::vector<bool> flags(keys_.size());
+		for (size_t kb = 0; kb < keys_.size(); kb++)
+		{
+			for (size_t other = 0; other < keys_.size(); other++)
+			{
+				if (other != kb && !keys_[kb].empty() && keys_[other] == keys_[kb])
+					flags[kb] = true;
+			}
+		}
+		return flags;
+	}
+
+	// What a wheel did with its keybind on every input event
+	bool held(size_t kb, const KeySet& pressedKeys) const { return matchesPartial(kb, pressedKeys) && !conflicts(kb, pressedKeys); }
+
+protected:
+	std::vector<KeySet> keys_;
+};
+
+}
@@ -0,0 +1,72 @@
+#include <KeybindMatcher.h>
+#include "KeybindBaseline.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+
+namespace GW2Radial
+{
+
+// Few enough keys that random chords often contain, duplicate and shadow each other
+static const uint MatcherKeys[] = { VK_LCONTROL, VK_LSHIFT, VK_LMENU, 'Q', 'W', 'E', 'R', 'F' };
+
+static KeyCombo RandomCombo(std::mt19937& rng, size_t maxSize)
+{
+	std::uniform_int_distribution<size_t> key(0, std::size(MatcherKeys) - 1), size(0, maxSize);
+	KeyCombo keys;
+	for (size_t n = size(rng); n > 0; n--)
+		keys.insert(MatcherKeys[key(rng)]);
+	return keys;
+}
+
+TEST(KeybindMatcher, MatchesPerKeybindLogic)
+{
+	std::mt19937 rng(17);
+	std::vector<std::unique_ptr<Keybind>> keybinds;
+	for (size_t i = 0; i < 24; i++)
+		keybinds.push_back(std::make_unique<Keybind>("matcher" + std::to_string(i), "Matcher", RandomCombo(rng, 4), false));
+
+	for (int round = 0; round < 2000; round++)
+	{
+		// Rebind one keybind now and then, which has to invalidate the compiled chords
+		if (round % 50 == 0)
+		{
+			auto& kb = *keybinds[round / 50 % keybinds.size()];
+			kb.isBeingModified(true);
+			kb.keys(RandomCombo(rng, 4));
+			kb.isBeingModified(false);
+		}
+
+		Baseline::SetKeybindRegistry baseline;
+		for (const auto& kb : keybinds)
+			baseline.Add(Baseline::KeySet(kb->keys().begin(), kb->keys().end()));
+
+		const auto pressed = RandomCombo(rng, 6);
+		const Baseline::KeySet pressedSet(pressed.begin(), pressed.end());
+
+		size_t longest = 0;
+		for (size_t kb = 0; kb < keybinds.size(); kb++)
+		{
+			const bool held = baseline.held(kb, pressedSet);
+			EXPECT_EQ(KeybindMatcher::wins(*keybinds[kb], pressed), held) << "round " << round << ", keybind " << kb;
+			EXPECT_EQ(keybinds[kb]->matchesPartial(pressed) && !keybinds[kb]->conflicts(pressed), held) << "round " << round << ", keybind " << kb;
+			if (baseline.matchesPartial(kb, pressedSet))
+				longest = std::max(longest, baseline.keys(kb).size());
+		}
+		EXPECT_EQ(KeybindMatcher::longestHeld(pressed), longest) << "round " << round;
+	}
+}
+
+TEST(KeybindMatcher, ForgetsDestroyedKeybinds)
+{
+	const KeyCombo pressed { VK_LCONTROL, VK_LSHIFT, 'Q' };
+	Keybind shortOne("matcher_short", "Matcher", { VK_LCONTROL, 'Q' }, false);
+	{
+		Keybind longOne("matcher_long", "Matcher", { VK_LCONTROL, VK_LSHIFT, 'Q' }, false);
+		EXPECT_FALSE(KeybindMatcher::wins(shortOne, pressed));
+	}
+	EXPECT_TRUE(KeybindMatcher::wins(shortOne, pressed));
+	EXPECT_EQ(KeybindMatcher::longestHeld(pressed), 2u);
+}
+
+}
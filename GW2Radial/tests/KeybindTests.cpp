@@ -0,0 +1,138 @@
+#include <Keybind.h>
+#include "KeybindBaseline.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+
+namespace GW2Radial
+{
+
+// Keys only change while the keybind is being modified, as when the user rebinds it in the settings
+static void Rebind(Keybind& kb, const KeyCombo& keys)
+{
+	kb.isBeingModified(true);
+	kb.keys(keys);
+	kb.isBeingModified(false);
+}
+
+TEST(Keybind, AddingADuplicateConflictsBoth)
+{
+	Keybind a("conflict_a", "A", { VK_LCONTROL, 'Q' }, false);
+	Keybind b("conflict_b", "B", { VK_LCONTROL, 'W' }, false);
+	EXPECT_FALSE(a.isConflicted());
+	EXPECT_FALSE(b.isConflicted());
+
+	Keybind c("conflict_c", "C", { 'Q', VK_LCONTROL }, false);
+	EXPECT_TRUE(a.isConflicted());
+	EXPECT_FALSE(b.isConflicted());
+	EXPECT_TRUE(c.isConflicted());
+}
+
+TEST(Keybind, RemovingLeavesTheRestOfTheGroupConflicted)
+{
+	Keybind a("conflict_a", "A", { 'F' }, false);
+	Keybind b("conflict_b", "B", { 'F' }, false);
+	auto c = std::make_unique<Keybind>("conflict_c", "C", KeyCombo { 'F' }, false);
+
+	c.reset();
+	EXPECT_TRUE(a.isConflicted());
+	EXPECT_TRUE(b.isConflicted());
+
+	// Clearing its keys takes a keybind out just the same
+	Rebind(b, {});
+	EXPECT_FALSE(a.isConflicted());
+	EXPECT_FALSE(b.isConflicted());
+}
+
+TEST(Keybind, ChangingKeysMovesBetweenGroups)
+{
+	Keybind a("conflict_a", "A", { VK_LSHIFT, 'E' }, false);
+	Keybind b("conflict_b", "B", { VK_LSHIFT, 'E' }, false);
+	Keybind c("conflict_c", "C", { 'R' }, false);
+	ASSERT_TRUE(a.isConflicted());
+
+	Rebind(b, { 'R' });
+	EXPECT_FALSE(a.isConflicted());
+	EXPECT_TRUE(b.isConflicted());
+	EXPECT_TRUE(c.isConflicted());
+
+	// Setting the keys it already has keeps it in its group
+	Rebind(b, { 'R' });
+	EXPECT_TRUE(b.isConflicted());
+	EXPECT_TRUE(c.isConflicted());
+
+	Rebind(c, { VK_LSHIFT, 'E' });
+	EXPECT_TRUE(a.isConflicted());
+	EXPECT_FALSE(b.isConflicted());
+	EXPECT_TRUE(c.isConflicted());
+}
+
+TEST(Keybind, KeysOnlyChangeWhileBeingModified)
+{
+	Keybind a("conflict_a", "A", { 'T' }, false);
+	Keybind b("conflict_b", "B", { 'G' }, false);
+	b.keys(KeyCombo { 'T' });
+	EXPECT_EQ(b.keys(), (KeyCombo { 'G' }));
+	EXPECT_FALSE(a.isConflicted());
+}
+
+TEST(Keybind, ShadowingFollowsChanges)
+{
+	Keybind shortOne("conflict_short", "Short", { VK_LCONTROL }, false);
+	Keybind longOne("conflict_long", "Long", { VK_LCONTROL, VK_LSHIFT }, false);
+	const KeyCombo pressed { VK_LCONTROL, VK_LSHIFT };
+	EXPECT_TRUE(shortOne.conflicts(pressed));
+
+	Rebind(longOne, { VK_LCONTROL, 'V' });
+	EXPECT_FALSE(shortOne.conflicts(pressed));
+	EXPECT_TRUE(shortOne.conflicts({ VK_LCONTROL, 'V' }));
+}
+
+// Random adds, removals and rebinds, checking every flag against the all-pairs scan after each one
+TEST(Keybind, IncrementalConflictsMatchFullScan)
+{
+	static const uint keys[] = { VK_LCONTROL, VK_LSHIFT, VK_LMENU, 'Q', 'W', 'E' };
+	std::mt19937 rng(16);
+	std::uniform_int_distribution<size_t> key(0, std::size(keys) - 1), size(0, 3), slot(0, 39), action(0, 2);
+	const auto randomCombo = [&]
+	{
+		KeyCombo combo;
+		for (size_t n = size(rng); n > 0; n--)
+			combo.insert(keys[key(rng)]);
+		return combo;
+	};
+
+	std::vector<std::unique_ptr<Keybind>> keybinds(40);
+	Baseline::SetKeybindRegistry baseline;
+	for (size_t i = 0; i < keybinds.size(); i++)
+		baseline.Add({});
+
+	for (int step = 0; step < 3000; step++)
+	{
+		const auto i = slot(rng);
+		KeyCombo combo = randomCombo();
+		switch (keybinds[i] ? action(rng) : 0)
+		{
+		case 0:
+			keybinds[i] = std::make_unique<Keybind>("conflict" + std::to_string(i), "Conflict", combo, false);
+			break;
+		case 1:
+			keybinds[i].reset();
+			combo.clear();
+			break;
+		default:
+			Rebind(*keybinds[i], combo);
+			break;
+		}
+		baseline.Set(i, Baseline::KeySet(combo.begin(), combo.end()));
+
+		const auto expected = baseline.conflicted();
+		for (size_t kb = 0; kb < keybinds.size(); kb++)
+		{
+			if (keybinds[kb])
+				ASSERT_EQ(keybinds[kb]->isConflicted(), expected[kb]) << "step " << step << ", keybind " << kb;
+		}
+	}
+}
+
+}
@@ -0,0 +1,133 @@
+#include <Platform.h>
+#include <Clock.h>
+#include <gtest/gtest.h>
+
+namespace GW2Radial
+{
+
+TEST(Platform, Utf8RoundTrip)
+{
+	const std::wstring text = L"Grüße, 世界 \U0001F600!";
+	const auto utf8 = utf8_encode(text);
+	EXPECT_EQ(utf8, "Gr\xC3\xBC\xC3\x9F" "e, \xE4\xB8\x96\xE7\x95\x8C \xF0\x9F\x98\x80!");
+	EXPECT_EQ(utf8_decode(utf8), text);
+	EXPECT_TRUE(utf8_encode(L"").empty());
+	EXPECT_TRUE(utf8_decode("").empty());
+}
+
+TEST(Platform, Utf8DecodeReplacesMalformedBytes)
+{
+	EXPECT_EQ(utf8_decode("a\xC3"), L"a�");
+	EXPECT_EQ(utf8_decode("\x80x"), L"�x");
+	EXPECT_EQ(utf8_decode("\xE4\x41"), L"�A");
+}
+
+TEST(Platform, KeyNames)
+{
+	RefreshKeyNames();
+	EXPECT_EQ(GetKeyName('A'), L"A");
+	EXPECT_EQ(KeyName('7'), "7");
+	EXPECT_TRUE(KeyName(300).empty());
+}
+
+TEST(Platform, KeyNameSnapshotOutlivesRefreshes)
+{
+	RefreshKeyNames();
+	const auto names = KeyNames();
+	const auto* name = &(*names)['A'];
+
+	// Two refreshes used to reuse the table handed out first
+	RefreshKeyNames();
+	RefreshKeyNames();
+	EXPECT_NE(KeyNames(), names);
+	EXPECT_EQ(&(*names)['A'], name);
+	EXPECT_EQ(*name, "A");
+}
+
+TEST(Clock, ConvertDoesNotOverflow)
+{
+	// Thirty years of a 10 MHz counter, where ticks * 1000000 alone would not fit in 64 bits
+	const int64_t tps = 10000000;
+	const int64_t ticks = tps * 60 * 60 * 24 * 365 * 30 + 12345;
+	EXPECT_EQ(Clock::Convert(ticks, tps, 1000000), ticks / 10);
+	EXPECT_EQ(Clock::Convert(3, 2, 1000), 1500);
+}
+
+TEST(Clock, Monotonic)
+{
+	auto last = Clock::microseconds();
+	for (int i = 0; i < 1000; i++)
+	{
+		const auto now = Clock::microseconds();
+		ASSERT_GE(now, last);
+		last = now;
+	}
+	EXPECT_GE(TimeInMilliseconds() + 1, mstime(last / 1000));
+}
+
+TEST(Clock, FrameTimeOnlyAdvancesOnBeginFrame)
+{
+	Clock::BeginFrame();
+	const auto frame = Clock::frameMicroseconds();
+	while (Clock::microseconds() == frame)
+		;
+	EXPECT_EQ(Clock::frameMicroseconds(), frame);
+	Clock::BeginFrame();
+	EXPECT_GT(Clock::frameMicroseconds(), frame);
+}
+
+// Ticks in milliseconds, moved by hand
+class SteppedClock : public ClockSource
+{
+public:
+	int64_t ticks() const override { return milliseconds; }
+	int64_t ticksPerSecond() const override { return 1000; }
+
+	int64_t milliseconds = 0;
+};
+
+class ClockSourceTest : public testing::Test
+{
+protected:
+	SteppedClock clock_;
+
+	void SetUp() override { Clock::source(&clock_); }
+	void TearDown() override { Clock::source(nullptr); }
+};
+
+TEST_F(ClockSourceTest, ReadingsFollowTheSource)
+{
+	EXPECT_EQ(&Clock::source(), &clock_);
+	clock_.milliseconds = 123456;
+	EXPECT_EQ(Clock::microseconds(), 123456000);
+	EXPECT_EQ(Clock::milliseconds(), 123456u);
+}
+
+TEST_F(ClockSourceTest, FrameMillisecondsHoldUntilNextFrame)
+{
+	clock_.milliseconds = 1000;
+	Clock::BeginFrame();
+	EXPECT_EQ(Clock::frameMilliseconds(), 1000u);
+
+	// A frame drawn at 60 fps; anything animated reads the same time throughout it
+	clock_.milliseconds += 16;
+	EXPECT_EQ(Clock::frameMilliseconds(), 1000u);
+	EXPECT_EQ(Clock::frameMicroseconds(), 1000000);
+
+	Clock::BeginFrame();
+	EXPECT_EQ(Clock::frameMilliseconds(), 1016u);
+
+	// A stalled frame jumps by however long it took
+	clock_.milliseconds += 250;
+	Clock::BeginFrame();
+	EXPECT_EQ(Clock::frameMilliseconds(), 1266u);
+}
+
+TEST_F(ClockSourceTest, ResettingGoesBackToTheCounter)
+{
+	Clock::source(nullptr);
+	EXPECT_EQ(&Clock::source(), &Clock::system());
+	EXPECT_GT(Clock::microseconds(), 0);
+}
+
+}
@@ -0,0 +1,55 @@
+#include "RecordedRawInput.h"
+#include <gtest/gtest.h>
+#include <cstddef>
+
+namespace GW2Radial
+{
+
+TEST(RawInput, HeaderMatchesTheWindowsLayout)
+{
+	// DWORD dwType, DWORD dwSize, HANDLE hDevice, WPARAM wParam
+	EXPECT_EQ(sizeof(RawInputHeader), 8 + 2 * sizeof(void*));
+	EXPECT_EQ(offsetof(RawInputHeader, size), 4u);
+	EXPECT_EQ(offsetof(RawInputHeader, device), 8u);
+}
+
+TEST(RawInput, OnlyMousePacketsAreMouse)
+{
+	RecordedRawInput input;
+	const auto mouse = input.Add(RawInputHeader::Mouse, 1, RecordedRawInput::MousePayload);
+	const auto keyboard = input.Add(RawInputHeader::Keyboard, 2, RecordedRawInput::KeyboardPayload);
+	const auto hid = input.Add(RawInputHeader::Hid, 3, RecordedRawInput::HidPayload);
+
+	EXPECT_TRUE(IsRawInputMouse(input, mouse));
+	EXPECT_FALSE(IsRawInputMouse(input, keyboard));
+	EXPECT_FALSE(IsRawInputMouse(input, hid));
+}
+
+TEST(RawInput, UnreadablePacketIsNotMouse)
+{
+	RecordedRawInput input;
+	input.Add(RawInputHeader::Mouse, 1, RecordedRawInput::MousePayload);
+
+	// Stale or bogus handles fail GetRawInputData the same way
+	EXPECT_FALSE(IsRawInputMouse(input, 0));
+	EXPECT_FALSE(IsRawInputMouse(input, 2));
+}
+
+TEST(RawInput, GamingStream)
+{
+	RecordedRawInput input;
+	const auto handles = input.AddGamingSecond();
+	ASSERT_EQ(handles.size(), 8000u + 1000 + 1000);
+
+	size_t mice = 0;
+	for (const auto handle : handles)
+	{
+		RawInputHeader header;
+		ASSERT_TRUE(input.Header(handle, header));
+		EXPECT_EQ(header.size, input.Packet(handle).size());
+		mice += IsRawInputMouse(input, handle);
+	}
+	EXPECT_EQ(mice, 8000u);
+}
+
+}
@@ -0,0 +1,60 @@
+#pragma once
+// Raw input packets laid out as GetRawInputData(RID_INPUT) hands them out, standing in for the system's
+// buffer: WM_INPUT handles are 1-based indices into the recorded stream.
+#include <RawInput.h>
+#include <cstring>
+#include <vector>
+
+namespace GW2Radial
+{
+
+class RecordedRawInput : public RawInputSource
+{
+public:
+	// Payload sizes of RAWMOUSE and RAWKEYBOARD, and of a HID report from a typical gamepad
+	static constexpr size_t MousePayload = 24;
+	static constexpr size_t KeyboardPayload = 16;
+	static constexpr size_t HidPayload = 8 + 64;
+
+	// Returns the handle the packet's WM_INPUT would carry
+	uintptr_t Add(RawInputHeader::Type type, uintptr_t device, size_t payload)
+	{
+		std::vector<uint8_t> packet(sizeof(RawInputHeader) + payload);
+		const RawInputHeader header { type, uint32_t(packet.size()), device, 0 };
+		memcpy(packet.data(), &header, sizeof(header));
+		packets_.push_back(std::move(packet));
+		return packets_.size();
+	}
+
+	bool Header(uintptr_t handle, RawInputHeader& header) const override
+	{
+		if (handle == 0 || handle > packets_.size())
+			return false;
+		memcpy(&header, packets_[handle - 1].data(), sizeof(header));
+		return true;
+	}
+
+	// The whole packet, header included
+	const std::vector<uint8_t>& Packet(uintptr_t handle) const { return packets_[handle - 1]; }
+
+	// One second of an 8000 Hz mouse, with a 1000 Hz keyboard and gamepad reporting in between;
+	// returns the handles in the order their WM_INPUTs arrive
+	std::vector<uintptr_t> AddGamingSecond()
+	{
+		std::vector<uintptr_t> handles;
+		for (int i = 0; i < 8000; i++)
+		{
+			handles.push_back(Add(RawInputHeader::Mouse, 0x1001, MousePayload));
+			if (i % 8 == 3)
+				handles.push_back(Add(RawInputHeader::Keyboard, 0x2001, KeyboardPayload));
+			if (i % 8 == 7)
+				handles.push_back(Add(RawInputHeader::Hid, 0x3001, HidPayload));
+		}
+		return handles;
+	}
+
+protected:
+	std::vector<std::vector<uint8_t>> packets_;
+};
+
+}
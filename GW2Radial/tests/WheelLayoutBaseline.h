@@ -0,0 +1,31 @@
+#pragma once
+// Hover lookup as Wheel::UpdateHover did it before WheelLayout: the active elements gathered and an atan2 on every mouse move
+#include <Main.h>
+#include <cmath>
+#include <vector>
+
+namespace GW2Radial::Baseline
+{
+
+inline int HoveredSector(size_t count, const fVector2& direction)
+{
+	float mouseAngle = atan2(direction.y, direction.x) - 0.5f * float(M_PI);
+	if (mouseAngle < 0)
+		mouseAngle += float(2 * M_PI);
+
+	const float elementAngle = float(2 * M_PI) / count;
+	return int((mouseAngle - elementAngle / 2) / elementAngle + 1) % count;
+}
+
+template<typename Element>
+const Element* Hovered(const std::vector<Element>& elements, const fVector2& direction)
+{
+	std::vector<const Element*> active;
+	for (const auto& e : elements)
+		if (e.isActive())
+			active.push_back(&e);
+
+	return active.empty() ? nullptr : active[HoveredSector(active.size(), direction)];
+}
+
+}
@@ -0,0 +1,64 @@
+#include <WheelLayout.h>
+#include "WheelLayoutBaseline.h"
+#include <gtest/gtest.h>
+#include <random>
+
+namespace GW2Radial
+{
+
+TEST(WheelLayout, SectorsMatchTheAngleFormula)
+{
+	std::mt19937 rng(21);
+	std::uniform_real_distribution<float> angle(0.f, float(2 * M_PI));
+	for (size_t count = 1; count <= 16; count++)
+	{
+		const WheelLayout layout(count);
+		ASSERT_EQ(layout.size(), count);
+
+		const float elementAngle = float(2 * M_PI) / count;
+		for (int i = 0; i < 1000; i++)
+		{
+			const float a = angle(rng);
+			// Right on a boundary the two can round to different sides
+			const float fromBoundary = std::fmod(a - 0.5f * float(M_PI) + 2.5f * elementAngle, elementAngle);
+			if (count > 1 && (fromBoundary < 1e-3f || fromBoundary > elementAngle - 1e-3f))
+				continue;
+
+			const fVector2 direction = { std::cos(a), std::sin(a) };
+			EXPECT_EQ(layout.HoveredSector(direction), Baseline::HoveredSector(count, direction)) << count << " elements at " << a;
+		}
+	}
+}
+
+TEST(WheelLayout, PointingAtAnElementHoversIt)
+{
+	for (size_t count = 1; count <= 16; count++)
+	{
+		const WheelLayout layout(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			// UpdateHover measures from the cursor to the center, the opposite of where the element is placed
+			const auto& location = layout[i].location;
+			EXPECT_EQ(layout.HoveredSector({ -location.x, -location.y }), int(i)) << count << " elements";
+		}
+	}
+}
+
+TEST(WheelLayout, ElementsOfAWheelAreTheSameSize)
+{
+	for (size_t count = 2; count <= 16; count++)
+	{
+		const WheelLayout layout(count);
+		for (size_t i = 1; i < count; i++)
+			EXPECT_EQ(layout[i].diameter, layout[0].diameter) << count << " elements";
+	}
+}
+
+TEST(WheelLayout, EmptyWheelHoversNothingInParticular)
+{
+	const WheelLayout layout;
+	EXPECT_EQ(layout.size(), 0u);
+	EXPECT_EQ(layout.HoveredSector({ 1.f, 0.f }), 0);
+}
+
+}
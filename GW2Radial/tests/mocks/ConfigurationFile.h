@@ -0,0 +1,43 @@
+#pragma once
+// Test build stand-in for ConfigurationFile: an in-memory ini with the same calls, never written to disk
+#include <Main.h>
+#include <map>
+
+namespace GW2Radial
+{
+
+class ConfigurationFile
+{
+public:
+	class Ini
+	{
+	public:
+		const char* GetValue(const char* section, const char* key) const
+		{
+			const auto it = values_.find({ section, key });
+			return it == values_.end() ? nullptr : it->second.c_str();
+		}
+
+		void SetValue(const char* section, const char* key, const char* value) { values_[{ section, key }] = value; }
+
+	protected:
+		std::map<std::pair<std::string, std::string>, std::string> values_;
+	};
+
+	static ConfigurationFile* i()
+	{
+		static ConfigurationFile instance;
+		return &instance;
+	}
+
+	void Save() { saves_++; }
+	size_t saves() const { return saves_; }
+
+	Ini& ini() { return ini_; }
+
+protected:
+	Ini ini_;
+	size_t saves_ = 0;
+};
+
+}
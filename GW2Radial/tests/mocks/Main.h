@@ -0,0 +1,75 @@
+#pragma once
+// Test build stand-in for Main.h: Platform.h plus the few windows.h names the code under test uses,
+// and the vector types and macros the drawing code needs on top of the mock d3d9.h
+#include <Platform.h>
+#include <d3d9.h>
+#include <Resource.h>
+#include <exception>
+
+#define COM_RELEASE(x) { if((x)) { (x)->Release(); (x) = nullptr; } }
+#define NULL_COALESCE(a, b) ((a) != nullptr ? (a) : (b))
+
+typedef struct fVector4 {
+	FLOAT x;
+	FLOAT y;
+	FLOAT z;
+	FLOAT w;
+} fVector4;
+
+typedef struct fVector3 {
+	FLOAT x;
+	FLOAT y;
+	FLOAT z;
+} fVector3;
+
+typedef struct fVector2 {
+	FLOAT x;
+	FLOAT y;
+} fVector2;
+
+enum : uint
+{
+	VK_LBUTTON = 0x01,
+	VK_RBUTTON = 0x02,
+	VK_MBUTTON = 0x04,
+	VK_XBUTTON1 = 0x05,
+	VK_XBUTTON2 = 0x06,
+	VK_SHIFT = 0x10,
+	VK_CONTROL = 0x11,
+	VK_MENU = 0x12,
+	VK_F10 = 0x79,
+	VK_LSHIFT = 0xA0,
+	VK_RSHIFT = 0xA1,
+	VK_LCONTROL = 0xA2,
+	VK_RCONTROL = 0xA3,
+	VK_LMENU = 0xA4,
+	VK_RMENU = 0xA5
+};
+
+enum : uint
+{
+	WM_KILLFOCUS = 0x0008,
+	WM_INPUT = 0x00FF,
+	WM_KEYDOWN = 0x0100,
+	WM_KEYUP = 0x0101,
+	WM_CHAR = 0x0102,
+	WM_SYSKEYDOWN = 0x0104,
+	WM_SYSKEYUP = 0x0105,
+	WM_MOUSEMOVE = 0x0200,
+	WM_LBUTTONDOWN = 0x0201,
+	WM_LBUTTONUP = 0x0202,
+	WM_RBUTTONDOWN = 0x0204,
+	WM_RBUTTONUP = 0x0205,
+	WM_MBUTTONDOWN = 0x0207,
+	WM_MBUTTONUP = 0x0208,
+	WM_XBUTTONDOWN = 0x020B,
+	WM_XBUTTONUP = 0x020C
+};
+
+enum : uint
+{
+	XBUTTON1 = 0x0001,
+	XBUTTON2 = 0x0002
+};
+
+#define GET_XBUTTON_WPARAM(wParam) (uint16_t((uintptr_t(wParam) >> 16) & 0xFFFF))
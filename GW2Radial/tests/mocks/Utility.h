@@ -0,0 +1,27 @@
+#pragma once
+#include <Main.h>
+#include <cstdarg>
+#include <cstdio>
+
+namespace GW2Radial
+{
+
+inline void FormattedOutputDebugString(const char* fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	vfprintf(stderr, fmt, args);
+	va_end(args);
+}
+
+// Nothing is embedded in test builds; every resource reads as the same few bytes, which is
+// all the mock device needs to hand out a shader
+inline bool LoadFontResource(UINT resId, void*& dataPtr, size_t& dataSize)
+{
+	static const DWORD dummy[] = { 0xFFFF0300, 0x0000FFFF };
+	dataPtr = (void*)dummy;
+	dataSize = sizeof(dummy);
+	return true;
+}
+
+}
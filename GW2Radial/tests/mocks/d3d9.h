@@ -0,0 +1,410 @@
+#pragma once
+// Test build stand-in for the parts of d3d9.h the drawing code uses, with the same constant values.
+// The device draws nothing; it keeps the state every Set call changes, so state blocks can capture and
+// restore it, and records the calls tests care about: how often each was made, shader constant uploads,
+// draw calls with their instance counts, and how many default pool buffers are alive.
+#include <Platform.h>
+#include <cstddef>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+typedef unsigned long DWORD;
+typedef unsigned long ULONG;
+typedef long HRESULT;
+typedef unsigned int UINT;
+typedef int INT;
+typedef unsigned short WORD;
+typedef unsigned char BYTE;
+typedef float FLOAT;
+typedef void* LPVOID;
+
+#define CopyMemory(dst, src, size) memcpy((dst), (src), (size))
+
+#define S_OK HRESULT(0)
+#define E_FAIL HRESULT(0x80004005L)
+#define SUCCEEDED(hr) (HRESULT(hr) >= 0)
+#define FAILED(hr) (HRESULT(hr) < 0)
+
+enum D3DRENDERSTATETYPE
+{
+	D3DRS_ZENABLE = 7,
+	D3DRS_ZWRITEENABLE = 14,
+	D3DRS_ALPHATESTENABLE = 15,
+	D3DRS_SRCBLEND = 19,
+	D3DRS_DESTBLEND = 20,
+	D3DRS_CULLMODE = 22,
+	D3DRS_ALPHABLENDENABLE = 27,
+	D3DRS_BLENDOP = 171
+};
+
+enum D3DSAMPLERSTATETYPE
+{
+	D3DSAMP_ADDRESSU = 1,
+	D3DSAMP_ADDRESSV = 2,
+	D3DSAMP_MAGFILTER = 5,
+	D3DSAMP_MINFILTER = 6,
+	D3DSAMP_MIPFILTER = 7
+};
+
+enum { D3DBLEND_ONE = 2, D3DBLEND_SRCALPHA = 5, D3DBLEND_INVSRCALPHA = 6 };
+enum { D3DBLENDOP_ADD = 1 };
+enum { D3DCULL_NONE = 1 };
+enum { D3DTADDRESS_MIRROR = 2, D3DTADDRESS_CLAMP = 3 };
+enum { D3DTEXF_LINEAR = 2 };
+
+enum D3DPRIMITIVETYPE { D3DPT_TRIANGLELIST = 4 };
+enum D3DSTATEBLOCKTYPE { D3DSBT_ALL = 1, D3DSBT_PIXELSTATE = 2, D3DSBT_VERTEXSTATE = 3 };
+enum D3DFORMAT { D3DFMT_UNKNOWN = 0, D3DFMT_INDEX16 = 101 };
+enum D3DPOOL { D3DPOOL_DEFAULT = 0, D3DPOOL_MANAGED = 1 };
+
+enum { D3DUSAGE_WRITEONLY = 0x8, D3DUSAGE_DYNAMIC = 0x200 };
+enum { D3DLOCK_READONLY = 0x10, D3DLOCK_DISCARD = 0x2000 };
+
+#define D3DSTREAMSOURCE_INDEXEDDATA (1u << 30)
+#define D3DSTREAMSOURCE_INSTANCEDATA (2u << 30)
+
+enum { D3DDECLTYPE_FLOAT2 = 1, D3DDECLTYPE_FLOAT4 = 3, D3DDECLTYPE_UNUSED = 17 };
+enum { D3DDECLMETHOD_DEFAULT = 0 };
+enum { D3DDECLUSAGE_TEXCOORD = 5 };
+
+struct D3DVERTEXELEMENT9
+{
+	WORD Stream;
+	WORD Offset;
+	BYTE Type;
+	BYTE Method;
+	BYTE Usage;
+	BYTE UsageIndex;
+};
+#define D3DDECL_END() { 0xFF, 0, D3DDECLTYPE_UNUSED, 0, 0, 0 }
+
+struct D3DVIEWPORT9
+{
+	DWORD X, Y, Width, Height;
+	float MinZ, MaxZ;
+};
+
+struct IDirect3DDevice9;
+
+// Reference counted like COM objects, so COM_RELEASE and AddRef work as in the real thing
+class MockResource
+{
+public:
+	virtual ~MockResource() = default;
+	ULONG AddRef() { return ++refs_; }
+	ULONG Release() { const auto r = --refs_; if (r == 0) delete this; return r; }
+
+protected:
+	ULONG refs_ = 1;
+};
+
+struct IDirect3DBaseTexture9 : MockResource { };
+struct IDirect3DTexture9 : IDirect3DBaseTexture9 { };
+struct IDirect3DVertexDeclaration9 : MockResource { };
+struct IDirect3DPixelShader9 : MockResource { };
+struct IDirect3DVertexShader9 : MockResource { };
+
+// One piece of device state: which Set call changes it, and the stage, stream, register or state type it was given
+enum class MockState
+{
+	RenderState,
+	SamplerState,
+	Texture,
+	PixelShader,
+	VertexShader,
+	VertexDeclaration,
+	Indices,
+	Viewport,
+	StreamSource,
+	StreamSourceFreq,
+	VertexShaderConstant,
+	PixelShaderConstant
+};
+
+struct MockStateKey
+{
+	MockState kind;
+	DWORD slot;
+	DWORD type;
+
+	bool operator<(const MockStateKey& other) const { return std::tie(kind, slot, type) < std::tie(other.kind, other.slot, other.type); }
+	bool operator==(const MockStateKey& other) const { return !(*this < other) && !(other < *this); }
+};
+
+// The bytes a Set call was given; state which was never set has no entry, as if still at its default
+using MockStateValues = std::map<MockStateKey, std::vector<BYTE>>;
+
+// Saves and restores the states it was recorded with, or every state the device has for D3DSBT_ALL
+class IDirect3DStateBlock9 : public MockResource
+{
+public:
+	IDirect3DStateBlock9(IDirect3DDevice9* device, std::set<MockStateKey> keys, bool all)
+		: device_(device), keys_(std::move(keys)), all_(all) { }
+
+	HRESULT Capture();
+	HRESULT Apply();
+
+	// How many states a Capture or Apply copies
+	size_t size() const;
+
+protected:
+	IDirect3DDevice9* device_;
+	std::set<MockStateKey> keys_;
+	bool all_;
+	MockStateValues values_;
+};
+
+// Vertex and index buffers alike; default pool ones are counted by the device until released
+class MockBuffer : public MockResource
+{
+public:
+	MockBuffer(IDirect3DDevice9* device, D3DPOOL pool, UINT length);
+	~MockBuffer() override;
+
+	HRESULT Lock(UINT offset, UINT size, void** data, DWORD)
+	{
+		if (offset + size > data_.size())
+			return E_FAIL;
+		*data = data_.data() + offset;
+		return S_OK;
+	}
+	HRESULT Unlock() { return S_OK; }
+
+protected:
+	IDirect3DDevice9* device_;
+	D3DPOOL pool_;
+	std::vector<BYTE> data_;
+};
+
+struct IDirect3DVertexBuffer9 : MockBuffer { using MockBuffer::MockBuffer; };
+struct IDirect3DIndexBuffer9 : MockBuffer { using MockBuffer::MockBuffer; };
+
+struct IDirect3DDevice9
+{
+	struct ConstantUpload
+	{
+		bool vertexShader;
+		UINT first;
+		UINT count;
+	};
+
+	// Calls made while a state block is being recorded only describe the block, so they neither change the state nor are counted
+	MockStateValues state;
+	std::map<std::string, size_t> calls;
+	// By state block Capture and Apply calls
+	size_t copiedStates = 0;
+	std::vector<ConstantUpload> constantUploads;
+	std::vector<UINT> drawInstanceCounts;
+	int defaultPoolBuffers = 0;
+
+	size_t uploadedBytes() const
+	{
+		size_t bytes = 0;
+		for (const auto& u : constantUploads)
+			bytes += u.count * 4 * sizeof(float);
+		return bytes;
+	}
+
+	HRESULT CreateVertexBuffer(UINT length, DWORD, DWORD, D3DPOOL pool, IDirect3DVertexBuffer9** buffer, void*)
+	{
+		*buffer = new IDirect3DVertexBuffer9(this, pool, length);
+		return S_OK;
+	}
+	HRESULT CreateIndexBuffer(UINT length, DWORD, D3DFORMAT, D3DPOOL pool, IDirect3DIndexBuffer9** buffer, void*)
+	{
+		*buffer = new IDirect3DIndexBuffer9(this, pool, length);
+		return S_OK;
+	}
+	HRESULT CreateVertexDeclaration(const D3DVERTEXELEMENT9*, IDirect3DVertexDeclaration9** declaration)
+	{
+		*declaration = new IDirect3DVertexDeclaration9;
+		return S_OK;
+	}
+	HRESULT CreatePixelShader(const DWORD*, IDirect3DPixelShader9** shader)
+	{
+		*shader = new IDirect3DPixelShader9;
+		return S_OK;
+	}
+	HRESULT CreateVertexShader(const DWORD*, IDirect3DVertexShader9** shader)
+	{
+		*shader = new IDirect3DVertexShader9;
+		return S_OK;
+	}
+
+	HRESULT BeginStateBlock()
+	{
+		recording_ = true;
+		recordedKeys_.clear();
+		return S_OK;
+	}
+	HRESULT EndStateBlock(IDirect3DStateBlock9** block)
+	{
+		recording_ = false;
+		*block = new IDirect3DStateBlock9(this, std::move(recordedKeys_), false);
+		return S_OK;
+	}
+	HRESULT CreateStateBlock(D3DSTATEBLOCKTYPE type, IDirect3DStateBlock9** block)
+	{
+		if (type != D3DSBT_ALL)
+			return E_FAIL;
+		*block = new IDirect3DStateBlock9(this, { }, true);
+		(*block)->Capture();
+		return S_OK;
+	}
+
+	HRESULT SetRenderState(D3DRENDERSTATETYPE type, DWORD value)
+	{
+		return Set("SetRenderState", { MockState::RenderState, 0, DWORD(type) }, &value, sizeof(value));
+	}
+	HRESULT SetSamplerState(DWORD sampler, D3DSAMPLERSTATETYPE type, DWORD value)
+	{
+		return Set("SetSamplerState", { MockState::SamplerState, sampler, DWORD(type) }, &value, sizeof(value));
+	}
+	HRESULT SetTexture(DWORD stage, IDirect3DBaseTexture9* texture)
+	{
+		return Set("SetTexture", { MockState::Texture, stage, 0 }, &texture, sizeof(texture));
+	}
+	HRESULT SetPixelShader(IDirect3DPixelShader9* shader)
+	{
+		return Set("SetPixelShader", { MockState::PixelShader, 0, 0 }, &shader, sizeof(shader));
+	}
+	HRESULT SetVertexShader(IDirect3DVertexShader9* shader)
+	{
+		return Set("SetVertexShader", { MockState::VertexShader, 0, 0 }, &shader, sizeof(shader));
+	}
+	HRESULT SetVertexDeclaration(IDirect3DVertexDeclaration9* declaration)
+	{
+		return Set("SetVertexDeclaration", { MockState::VertexDeclaration, 0, 0 }, &declaration, sizeof(declaration));
+	}
+	HRESULT SetIndices(IDirect3DIndexBuffer9* indices)
+	{
+		return Set("SetIndices", { MockState::Indices, 0, 0 }, &indices, sizeof(indices));
+	}
+	HRESULT SetViewport(const D3DVIEWPORT9* viewport)
+	{
+		return Set("SetViewport", { MockState::Viewport, 0, 0 }, viewport, sizeof(*viewport));
+	}
+	HRESULT SetStreamSource(UINT stream, IDirect3DVertexBuffer9* buffer, UINT offset, UINT stride)
+	{
+		const struct { IDirect3DVertexBuffer9* buffer; UINT offset, stride; } source = { buffer, offset, stride };
+		return Set("SetStreamSource", { MockState::StreamSource, stream, 0 }, &source, sizeof(source));
+	}
+
+	HRESULT SetStreamSourceFreq(UINT stream, UINT setting)
+	{
+		if (!recording_ && stream == 0)
+			stream0Frequency_ = setting;
+		return Set("SetStreamSourceFreq", { MockState::StreamSourceFreq, stream, 0 }, &setting, sizeof(setting));
+	}
+
+	// Every register is a state of its own, as a state block saves them
+	HRESULT SetVertexShaderConstantF(UINT first, const float* data, UINT count)
+	{
+		if (!recording_)
+			constantUploads.push_back({ true, first, count });
+		for (UINT r = 0; r < count; r++)
+			Set(nullptr, { MockState::VertexShaderConstant, first + r, 0 }, data + r * 4, 4 * sizeof(float));
+		return Count("SetVertexShaderConstantF");
+	}
+	HRESULT SetPixelShaderConstantF(UINT first, const float* data, UINT count)
+	{
+		if (!recording_)
+			constantUploads.push_back({ false, first, count });
+		for (UINT r = 0; r < count; r++)
+			Set(nullptr, { MockState::PixelShaderConstant, first + r, 0 }, data + r * 4, 4 * sizeof(float));
+		return Count("SetPixelShaderConstantF");
+	}
+
+	HRESULT DrawIndexedPrimitive(D3DPRIMITIVETYPE, INT, UINT, UINT, UINT, UINT)
+	{
+		drawInstanceCounts.push_back(stream0Frequency_ & D3DSTREAMSOURCE_INDEXEDDATA ? stream0Frequency_ & 0xFFFF : 1);
+		return Count("DrawIndexedPrimitive");
+	}
+
+	HRESULT Count(const char* call)
+	{
+		if (!recording_)
+			calls[call]++;
+		return S_OK;
+	}
+
+protected:
+	bool recording_ = false;
+	std::set<MockStateKey> recordedKeys_;
+	UINT stream0Frequency_ = 1;
+
+	HRESULT Set(const char* call, const MockStateKey& key, const void* value, size_t size)
+	{
+		if (recording_)
+		{
+			recordedKeys_.insert(key);
+			return S_OK;
+		}
+
+		const auto* bytes = static_cast<const BYTE*>(value);
+		state[key].assign(bytes, bytes + size);
+		return call ? Count(call) : S_OK;
+	}
+};
+
+inline HRESULT IDirect3DStateBlock9::Capture()
+{
+	device_->Count("IDirect3DStateBlock9::Capture");
+	device_->copiedStates += all_ ? device_->state.size() : keys_.size();
+	if (all_)
+	{
+		values_ = device_->state;
+		return S_OK;
+	}
+
+	values_.clear();
+	for (const auto& key : keys_)
+	{
+		const auto it = device_->state.find(key);
+		values_[key] = it == device_->state.end() ? std::vector<BYTE>() : it->second;
+	}
+	return S_OK;
+}
+
+inline HRESULT IDirect3DStateBlock9::Apply()
+{
+	device_->Count("IDirect3DStateBlock9::Apply");
+	device_->copiedStates += size();
+	if (all_)
+	{
+		device_->state = values_;
+		return S_OK;
+	}
+
+	// A state which was at its default when captured goes back to it
+	for (const auto& [key, value] : values_)
+	{
+		if (value.empty())
+			device_->state.erase(key);
+		else
+			device_->state[key] = value;
+	}
+	return S_OK;
+}
+
+inline size_t IDirect3DStateBlock9::size() const
+{
+	return all_ ? values_.size() : keys_.size();
+}
+
+inline MockBuffer::MockBuffer(IDirect3DDevice9* device, D3DPOOL pool, UINT length)
+	: device_(device), pool_(pool), data_(length)
+{
+	if (pool_ == D3DPOOL_DEFAULT)
+		device_->defaultPoolBuffers++;
+}
+
+inline MockBuffer::~MockBuffer()
+{
+	if (pool_ == D3DPOOL_DEFAULT)
+		device_->defaultPoolBuffers--;
+}